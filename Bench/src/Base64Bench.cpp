@@ -0,0 +1,112 @@
+//
+// Base64 decoding: the vectorized decoder against the previous Poco stream path.
+//
+
+#include "Base64.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <Poco/Base64Decoder.h>
+#include <benchmark/benchmark.h>
+
+namespace
+{
+  using namespace Open3SDCM::detail;
+
+  // DCM payloads are either one long line or wrapped at 76 columns
+  std::string MakeEncodedPayload(const std::size_t decodedSize, const std::size_t lineLength)
+  {
+    static constexpr std::string_view alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::mt19937 generator(42U);
+    std::uniform_int_distribution<int> symbol(0, 63);
+
+    const std::size_t encodedSize = (decodedSize / 3U) * 4U;
+    std::string encoded;
+    encoded.reserve(encodedSize + encodedSize / std::max<std::size_t>(lineLength, 1U) * 2U);
+    for (std::size_t i = 0; i < encodedSize; ++i)
+    {
+      encoded.push_back(alphabet[static_cast<std::size_t>(symbol(generator))]);
+      if (lineLength != 0 && (i + 1) % lineLength == 0)
+      {
+        encoded += "\r\n";
+      }
+    }
+    return encoded;
+  }
+
+  // The decoder used before Base64.h: whitespace stripped on a copy, then
+  // istringstream -> Poco::Base64Decoder -> 4 KB chunk inserts
+  std::vector<char> DecodeLegacy(std::string_view base64Text, const std::size_t estimatedBufferSize)
+  {
+    std::string cleaned(base64Text);
+    std::erase_if(cleaned, [](const unsigned char c) { return std::isspace(c) != 0; });
+    std::istringstream inStream(cleaned);
+    Poco::Base64Decoder decoder(inStream);
+    std::vector<char> rawData;
+    rawData.reserve(estimatedBufferSize);
+    std::array<char, 4096U> chunk;
+    while (decoder.read(chunk.data(), sizeof(chunk)))
+    {
+      rawData.insert(rawData.end(), chunk.begin(), chunk.begin() + decoder.gcount());
+    }
+    if (decoder.gcount() > 0)
+    {
+      rawData.insert(rawData.end(), chunk.begin(), chunk.begin() + decoder.gcount());
+    }
+    return rawData;
+  }
+
+  void BM_Base64Legacy(benchmark::State& state)
+  {
+    const auto decodedSize = static_cast<std::size_t>(state.range(0));
+    const std::string encoded = MakeEncodedPayload(decodedSize, static_cast<std::size_t>(state.range(1)));
+    for (auto _ : state)
+    {
+      auto decoded = DecodeLegacy(encoded, decodedSize);
+      benchmark::DoNotOptimize(decoded.data());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * encoded.size()));
+  }
+
+  void BM_Base64(benchmark::State& state, const base64::Isa isa)
+  {
+    if (!base64::IsSupported(isa))
+    {
+      state.SkipWithError("instruction set not supported on this CPU");
+      return;
+    }
+
+    const auto decodedSize = static_cast<std::size_t>(state.range(0));
+    const std::string encoded = MakeEncodedPayload(decodedSize, static_cast<std::size_t>(state.range(1)));
+    std::vector<std::uint8_t> decoded(base64::MaxDecodedSize(encoded.size()) + base64::kOutputSlack);
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(base64::Decode(encoded, decoded.data(), isa));
+      benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * encoded.size()));
+  }
+
+  // {decoded bytes, line length (0 = single line)}
+  void PayloadSizes(benchmark::internal::Benchmark* benchmark)
+  {
+    for (const std::int64_t size : {std::int64_t{64} << 10, std::int64_t{4} << 20})
+    {
+      benchmark->Args({size, 0});
+      benchmark->Args({size, 76});
+    }
+  }
+}// namespace
+
+BENCHMARK(BM_Base64Legacy)->Apply(PayloadSizes);
+BENCHMARK_CAPTURE(BM_Base64, scalar, base64::Isa::Scalar)->Apply(PayloadSizes);
+BENCHMARK_CAPTURE(BM_Base64, sse41, base64::Isa::Sse41)->Apply(PayloadSizes);
+BENCHMARK_CAPTURE(BM_Base64, avx2, base64::Isa::Avx2)->Apply(PayloadSizes);
+BENCHMARK_CAPTURE(BM_Base64, neon, base64::Isa::Neon)->Apply(PayloadSizes);
@@ -0,0 +1,177 @@
+//
+// Inputs shared by the benchmarks: the TestData scans and synthetic scaled-up DCMs.
+//
+
+#include "BenchData.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#ifndef TEST_DATA_DIR
+#define TEST_DATA_DIR "."
+#endif
+
+namespace fs = std::filesystem;
+
+namespace bench
+{
+  namespace
+  {
+    // Vertex counts of the synthetic inputs: about 4x and 32x a typical full-arch scan
+    constexpr std::size_t kSyntheticVertexCounts[] = {std::size_t{1} << 18, std::size_t{1} << 21};
+
+    std::string ReadFile(const fs::path& path)
+    {
+      std::ifstream input(path, std::ios::binary);
+      return std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    }
+
+    std::string EncodeBase64(const std::vector<std::uint8_t>& bytes)
+    {
+      static constexpr std::string_view alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+      std::string encoded;
+      encoded.reserve((bytes.size() + 2) / 3 * 4);
+      std::size_t offset = 0;
+      for (; offset + 3 <= bytes.size(); offset += 3)
+      {
+        const std::uint32_t group = (std::uint32_t{bytes[offset]} << 16U) | (std::uint32_t{bytes[offset + 1]} << 8U) | bytes[offset + 2];
+        encoded += alphabet[(group >> 18U) & 63U];
+        encoded += alphabet[(group >> 12U) & 63U];
+        encoded += alphabet[(group >> 6U) & 63U];
+        encoded += alphabet[group & 63U];
+      }
+      if (offset < bytes.size())
+      {
+        const bool two = offset + 1 < bytes.size();
+        const std::uint32_t group = (std::uint32_t{bytes[offset]} << 16U) | (two ? std::uint32_t{bytes[offset + 1]} << 8U : 0U);
+        encoded += alphabet[(group >> 18U) & 63U];
+        encoded += alphabet[(group >> 12U) & 63U];
+        encoded += two ? alphabet[(group >> 6U) & 63U] : '=';
+        encoded += '=';
+      }
+      return encoded;
+    }
+
+    std::unique_ptr<BenchInput> LoadInput(std::string name, fs::path path, std::string content)
+    {
+      auto input = std::make_unique<BenchInput>();
+      input->name = std::move(name);
+      input->path = std::move(path);
+      input->content = std::move(content);
+      input->document = Open3SDCM::detail::ScanDcmDocument(input->content);
+      return input;
+    }
+
+    std::vector<std::unique_ptr<BenchInput>> BuildInputs()
+    {
+      const fs::path dataDirectory(TEST_DATA_DIR);
+      std::vector<fs::path> scans = {dataDirectory / "Hole3x5" / "Hole 3x5.dcm",
+                                     dataDirectory / "Handle" / "HandleAngledLarge.dcm",
+                                     dataDirectory / "Scan-01" / "Scan.dcm"};
+      std::error_code errorCode;
+      std::vector<fs::path> realWorld;
+      for (const auto& entry : fs::directory_iterator(dataDirectory / "real-world", errorCode))
+      {
+        if (entry.path().extension() == ".dcm")
+        {
+          realWorld.push_back(entry.path());
+        }
+      }
+      std::sort(realWorld.begin(), realWorld.end());
+      scans.insert(scans.end(), realWorld.begin(), realWorld.end());
+
+      std::vector<std::unique_ptr<BenchInput>> inputs;
+      for (const auto& scan : scans)
+      {
+        if (!fs::is_regular_file(scan, errorCode))
+        {
+          continue;
+        }
+        // Spaces would get in the way of --benchmark_filter
+        std::string name = (scan.parent_path().filename() / scan.stem()).generic_string();
+        std::replace(name.begin(), name.end(), ' ', '_');
+        inputs.push_back(LoadInput(name, scan, ReadFile(scan)));
+      }
+
+      const fs::path syntheticDirectory = fs::temp_directory_path() / "Open3SDCM_bench" / "synthetic";
+      fs::create_directories(syntheticDirectory, errorCode);
+      for (const std::size_t vertexCount : kSyntheticVertexCounts)
+      {
+        const std::string stem = fmt::format("v{}", vertexCount);
+        const fs::path path = syntheticDirectory / (stem + ".dcm");
+        std::string content = MakeSyntheticDcm(vertexCount);
+        std::ofstream(path, std::ios::binary).write(content.data(), static_cast<std::streamsize>(content.size()));
+        inputs.push_back(LoadInput("synthetic/" + stem, path, std::move(content)));
+      }
+      return inputs;
+    }
+  }// namespace
+
+  const std::vector<std::unique_ptr<BenchInput>>& Inputs()
+  {
+    static const std::vector<std::unique_ptr<BenchInput>> inputs = BuildInputs();
+    return inputs;
+  }
+
+  std::string MakeSyntheticDcm(const std::size_t vertexCount)
+  {
+    // A height field on a square grid
+    const auto side = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(vertexCount))));
+    std::vector<std::uint8_t> vertexBytes(vertexCount * 3 * sizeof(float));
+    for (std::size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+    {
+      const float column = static_cast<float>(vertexIndex % side);
+      const float row = static_cast<float>(vertexIndex / side);
+      const float position[3] = {column * 0.05F, row * 0.05F, 0.5F * std::sin(column * 0.1F) * std::cos(row * 0.1F)};
+      std::memcpy(vertexBytes.data() + vertexIndex * sizeof(position), position, sizeof(position));// little-endian hosts
+    }
+
+    // RESTART (one face on three new vertices), then VERTEX_LIST + PREVIOUS pairs:
+    // each pair takes one new vertex and adds two faces, and the boundary keeps its size
+    std::vector<std::uint8_t> facetBytes;
+    facetBytes.reserve(1 + 2 * vertexCount);
+    facetBytes.push_back(4);
+    for (std::size_t vertexIndex = 3; vertexIndex < vertexCount; ++vertexIndex)
+    {
+      facetBytes.push_back(0);
+      facetBytes.push_back(1);
+    }
+    const std::size_t facetCount = 1 + 2 * (vertexCount - 3);
+
+    const std::string vertexText = EncodeBase64(vertexBytes);
+    const std::string facetText = EncodeBase64(facetBytes);
+    return fmt::format(R"(<HPS version="1.1">
+  <Packed_geometry>
+    <Schema>CA</Schema>
+    <Binary_data>
+      <CA version="1.0">
+        <Facets facet_count="{}" base64_encoded_bytes="{}" color="8421504">{}</Facets>
+        <Vertices vertex_count="{}" base64_encoded_bytes="{}">{}</Vertices>
+      </CA>
+    </Binary_data>
+  </Packed_geometry>
+  <Properties/>
+</HPS>
+)",
+                       facetCount, facetBytes.size(), facetText, vertexCount, vertexBytes.size(), vertexText);
+  }
+
+  const fs::path& OutputDirectory()
+  {
+    static const fs::path directory = [] {
+      const fs::path path = fs::temp_directory_path() / "Open3SDCM_bench" / "output";
+      std::error_code errorCode;
+      fs::remove_all(path, errorCode);
+      fs::create_directories(path, errorCode);
+      return path;
+    }();
+    return directory;
+  }
+}// namespace bench
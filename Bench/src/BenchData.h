@@ -0,0 +1,38 @@
+//
+// Inputs shared by the benchmarks: the TestData scans and synthetic scaled-up DCMs.
+//
+
+#pragma once
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "DcmDocument.h"
+
+namespace bench
+{
+  // One DCM held in memory. The element texts of `document` point into `content`,
+  // hence the inputs are handed out by pointer and never move.
+  struct BenchInput
+  {
+    std::string name;           // e.g. "Scan-01/Scan", "synthetic/v2097152"
+    std::filesystem::path path; // the file ParseDCM reads; synthetic inputs are written to the temp directory
+    std::string content;
+    Open3SDCM::detail::DcmDocument document;
+  };
+
+  // The TestData scans found on disk (Hole3x5, Handle, Scan-01, real-world/*), then
+  // the synthetic inputs. Built on first use.
+  const std::vector<std::unique_ptr<BenchInput>>& Inputs();
+
+  // A plain (CA schema) DCM of a `vertexCount`-vertex mesh with about twice as many
+  // triangles, the vertex/face ratio of the scans
+  std::string MakeSyntheticDcm(std::size_t vertexCount);
+
+  // Scratch directory for exported files, emptied on first use
+  const std::filesystem::path& OutputDirectory();
+
+  void RegisterDecodeBenchmarks();
+  void RegisterMeshBenchmarks();
+}// namespace bench
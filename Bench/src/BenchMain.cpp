@@ -0,0 +1,50 @@
+//
+// Benchmark driver: registers the data-driven benchmarks, and writes JSON results
+// next to the console report unless told otherwise.
+//
+
+#include "BenchData.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#ifndef OPEN3SDCM_VERSION
+#define OPEN3SDCM_VERSION "unknown"
+#endif
+
+int main(int argc, char** argv)
+{
+  // Results are tracked across releases: default to a JSON file, overridable with
+  // --benchmark_out=<file> (and --benchmark_format=json for JSON on stdout)
+  std::vector<char*> arguments(argv, argv + argc);
+  bool hasOutputFile = false;
+  for (int argumentIndex = 1; argumentIndex < argc; ++argumentIndex)
+  {
+    hasOutputFile = hasOutputFile || std::string_view(argv[argumentIndex]).starts_with("--benchmark_out=");
+  }
+  std::string outputFile = "--benchmark_out=Open3SDCMBench.json";
+  std::string outputFormat = "--benchmark_out_format=json";
+  if (!hasOutputFile)
+  {
+    arguments.push_back(outputFile.data());
+    arguments.push_back(outputFormat.data());
+  }
+  int argumentCount = static_cast<int>(arguments.size());
+
+  benchmark::Initialize(&argumentCount, arguments.data());
+  if (benchmark::ReportUnrecognizedArguments(argumentCount, arguments.data()))
+  {
+    return 1;
+  }
+
+  benchmark::AddCustomContext("open3sdcm_version", OPEN3SDCM_VERSION);
+  bench::RegisterDecodeBenchmarks();
+  bench::RegisterMeshBenchmarks();
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
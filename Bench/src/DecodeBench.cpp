@@ -0,0 +1,181 @@
+//
+// The decoding stages of ParseDCM on each input: base64, Blowfish, facet opcodes, UVs.
+//
+
+#include "BenchData.h"
+#include "DcmDecoders.h"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace bench
+{
+  namespace
+  {
+    using namespace Open3SDCM::detail;
+
+    std::size_t ElementCount(const DcmElement& element, const std::string& attribute)
+    {
+      return static_cast<std::size_t>(std::stoull(std::string(element.GetAttribute(attribute))));
+    }
+
+    void DecodeBufferBench(benchmark::State& state, const DcmElement& element)
+    {
+      const std::string_view text = element.InnerText();
+      for (auto _ : state)
+      {
+        auto rawData = DecodeBuffer(text);
+        benchmark::DoNotOptimize(rawData.data());
+      }
+      state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+    }
+
+    // DecryptBuffer works in place on its argument, so every iteration decrypts a
+    // fresh copy. The copy is timed too: pausing the timer around it costs as much
+    // as decrypting the small scan payloads. CopyPayloadBench is the copy alone.
+    void DecryptBufferBench(benchmark::State& state,
+                            const std::vector<char>& encrypted,
+                            std::string_view schema,
+                            const PropertyMap& properties)
+    {
+      for (auto _ : state)
+      {
+        auto decrypted = DecryptBuffer(std::vector<char>(encrypted), schema, properties);
+        benchmark::DoNotOptimize(decrypted.data());
+      }
+      state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * encrypted.size()));
+    }
+
+    void CopyPayloadBench(benchmark::State& state, const std::vector<char>& encrypted)
+    {
+      for (auto _ : state)
+      {
+        std::vector<char> data(encrypted);
+        benchmark::DoNotOptimize(data.data());
+        benchmark::ClobberMemory();
+      }
+      state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * encrypted.size()));
+    }
+
+    void InterpretFacetsBench(benchmark::State& state, const std::vector<char>& facetBytes, const std::size_t facetCount)
+    {
+      Open3SDCM::FacetDecodeInfo info;
+      for (auto _ : state)
+      {
+        auto triangles = InterpretFacetsBuffer(facetBytes, facetCount, info);
+        benchmark::DoNotOptimize(triangles.data());
+      }
+      state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * facetCount));
+      state.counters["decode_passes"] = static_cast<double>(info.decodePasses);
+    }
+
+    void DecodeTextureCoordinatesBench(benchmark::State& state,
+                                       const std::vector<char>& uvStream,
+                                       const std::size_t vertexCount,
+                                       const std::vector<Open3SDCM::Triangle>& triangles)
+    {
+      for (auto _ : state)
+      {
+        auto corners = DecodePerVertexTextureCoordinates(uvStream, vertexCount, triangles);
+        benchmark::DoNotOptimize(corners.data());
+      }
+      state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * triangles.size() * 3));
+    }
+
+    // Stage inputs are prepared once at registration; the benchmarks only borrow them
+    struct StageData
+    {
+      std::vector<char> encryptedPayload;
+      std::vector<char> facets;
+      std::vector<Open3SDCM::Triangle> triangles;
+      std::vector<std::vector<char>> uvStreams;
+    };
+
+    std::vector<std::unique_ptr<StageData>>& AllStageData()
+    {
+      static std::vector<std::unique_ptr<StageData>> stageData;
+      return stageData;
+    }
+  }// namespace
+
+  void RegisterDecodeBenchmarks()
+  {
+    const PropertyMap* ceProperties = nullptr;
+    for (const auto& inputPointer : Inputs())
+    {
+      const BenchInput& input = *inputPointer;
+      const DcmDocument& document = input.document;
+      if (!document.vertices.has_value() || !document.facets.has_value())
+      {
+        continue;
+      }
+      if (document.schema == "CE" && ceProperties == nullptr)
+      {
+        ceProperties = &document.properties;
+      }
+
+      // RegisterBenchmark's extra arguments are captured by copy; the inputs are captured by reference instead
+      benchmark::RegisterBenchmark(("DecodeBuffer/vertices/" + input.name).c_str(),
+                                   [&document](benchmark::State& state) { DecodeBufferBench(state, *document.vertices); });
+      benchmark::RegisterBenchmark(("DecodeBuffer/facets/" + input.name).c_str(),
+                                   [&document](benchmark::State& state) { DecodeBufferBench(state, *document.facets); });
+
+      auto& data = *AllStageData().emplace_back(std::make_unique<StageData>());
+      // Facet payloads are not encrypted; Blowfish is measured on the CE vertex payloads
+      data.facets = DecodeBuffer(document.facets->InnerText());
+      if (document.schema == "CE")
+      {
+        data.encryptedPayload = DecodeBuffer(document.vertices->InnerText());
+        benchmark::RegisterBenchmark(("DecryptBuffer/vertices/" + input.name).c_str(), [&data, &document](benchmark::State& state) {
+          DecryptBufferBench(state, data.encryptedPayload, document.schema, document.properties);
+        });
+        benchmark::RegisterBenchmark(("CopyPayload/vertices/" + input.name).c_str(),
+                                     [&data](benchmark::State& state) { CopyPayloadBench(state, data.encryptedPayload); });
+      }
+
+      const std::size_t facetCount = ElementCount(*document.facets, "facet_count");
+      benchmark::RegisterBenchmark(("InterpretFacetsBuffer/" + input.name).c_str(),
+                                   [&data, facetCount](benchmark::State& state) { InterpretFacetsBench(state, data.facets, facetCount); });
+
+      Open3SDCM::FacetDecodeInfo info;
+      data.triangles = InterpretFacetsBuffer(data.facets, facetCount, info);
+      const std::size_t vertexCount = ElementCount(*document.vertices, "vertex_count");
+      data.uvStreams.resize(document.textureCoordinates.size());
+      for (std::size_t setIndex = 0; setIndex < document.textureCoordinates.size(); ++setIndex)
+      {
+        Open3SDCM::TextureCoordinateData attributes;
+        data.uvStreams[setIndex] = ReadTextureCoordinateStream(document.textureCoordinates[setIndex], document.schema, document.properties, attributes);
+        benchmark::RegisterBenchmark(("DecodePerVertexTextureCoordinates/" + input.name + "/" + std::to_string(setIndex)).c_str(),
+                                     [&data, setIndex, vertexCount](benchmark::State& state) {
+                                       DecodeTextureCoordinatesBench(state, data.uvStreams[setIndex], vertexCount, data.triangles);
+                                     });
+      }
+    }
+
+    // Blowfish throughput on payloads larger than any scan, keyed like the first CE scan
+    if (ceProperties != nullptr)
+    {
+      for (const std::size_t size : {std::size_t{16} << 20, std::size_t{128} << 20})
+      {
+        auto& data = *AllStageData().emplace_back(std::make_unique<StageData>());
+        data.encryptedPayload.resize(size);
+        std::mt19937 generator(42U);
+        for (char& byte : data.encryptedPayload)
+        {
+          byte = static_cast<char>(generator());
+        }
+        benchmark::RegisterBenchmark(("DecryptBuffer/synthetic/" + std::to_string(size >> 20) + "MiB").c_str(),
+                                     [&data, ceProperties](benchmark::State& state) {
+                                       DecryptBufferBench(state, data.encryptedPayload, "CE", *ceProperties);
+                                     });
+        benchmark::RegisterBenchmark(("CopyPayload/synthetic/" + std::to_string(size >> 20) + "MiB").c_str(),
+                                     [&data](benchmark::State& state) { CopyPayloadBench(state, data.encryptedPayload); });
+      }
+    }
+  }
+}// namespace bench
@@ -0,0 +1,97 @@
+//
+// Whole-file work on each input: ParseDCM from disk, then ExportMesh in every format.
+//
+
+#include "BenchData.h"
+#include "ParseDcm.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace bench
+{
+  namespace
+  {
+    constexpr const char* kExportFormats[] = {"stl", "stlb", "ply", "plyb", "obj", "glb"};
+
+    void SetMeshCounters(benchmark::State& state, const Open3SDCM::DCMParser& parser)
+    {
+      state.counters["vertices"] = static_cast<double>(parser.m_Vertices.size() / 3);
+      state.counters["triangles"] = static_cast<double>(parser.m_Triangles.size());
+    }
+
+    void ParseDcmBench(benchmark::State& state, const BenchInput& input, const Open3SDCM::ParseOptions& options)
+    {
+      Open3SDCM::DCMParser parser;
+      for (auto _ : state)
+      {
+        parser.ParseDCM(input.path, options);
+        benchmark::DoNotOptimize(parser.m_Vertices.data());
+      }
+      state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * input.content.size()));
+      SetMeshCounters(state, parser);
+    }
+
+    void ExportMeshBench(benchmark::State& state, const Open3SDCM::DCMParser& parser, const std::string& format, const std::filesystem::path& outputPath)
+    {
+      for (auto _ : state)
+      {
+        if (!parser.ExportMesh(outputPath, format))
+        {
+          state.SkipWithError("export failed");
+          break;
+        }
+      }
+      std::error_code errorCode;
+      const auto outputSize = std::filesystem::file_size(outputPath, errorCode);
+      state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * (errorCode ? 0 : outputSize)));
+      SetMeshCounters(state, parser);
+    }
+
+    std::vector<std::unique_ptr<Open3SDCM::DCMParser>>& ParsedInputs()
+    {
+      static std::vector<std::unique_ptr<Open3SDCM::DCMParser>> parsers;
+      return parsers;
+    }
+  }// namespace
+
+  void RegisterMeshBenchmarks()
+  {
+    for (const auto& inputPointer : Inputs())
+    {
+      const BenchInput& input = *inputPointer;
+      benchmark::RegisterBenchmark(("ParseDCM/" + input.name).c_str(), [&input](benchmark::State& state) {
+        ParseDcmBench(state, input, {});
+      })->Unit(benchmark::kMillisecond);
+      benchmark::RegisterBenchmark(("ParseDCM/concurrent/" + input.name).c_str(), [&input](benchmark::State& state) {
+        Open3SDCM::ParseOptions options;
+        options.concurrentDecode = true;
+        ParseDcmBench(state, input, options);
+      })->Unit(benchmark::kMillisecond);
+
+      const auto& parser = *ParsedInputs().emplace_back(std::make_unique<Open3SDCM::DCMParser>());
+      ParsedInputs().back()->ParseDCMBuffer(input.content);
+      if (parser.m_Triangles.empty())
+      {
+        continue;
+      }
+
+      for (const std::string format : kExportFormats)
+      {
+        // Same-named files of different folders get distinct outputs
+        std::string stem = input.name;
+        std::replace(stem.begin(), stem.end(), '/', '_');
+        const auto outputPath = OutputDirectory() / (stem + "." + format);
+        benchmark::RegisterBenchmark(("ExportMesh/" + format + "/" + input.name).c_str(), [&parser, format, outputPath](benchmark::State& state) {
+          ExportMeshBench(state, parser, format, outputPath);
+        })->Unit(benchmark::kMillisecond);
+      }
+    }
+  }
+}// namespace bench
@@ -0,0 +1,642 @@
+//
+// Concurrent conversion of many DCM files for the CLI directory mode.
+//
+
+#include "BatchConverter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include "Poco/Exception.h"
+#include "fmt/format.h"
+
+#include "BoundedQueue.h"
+#include "Log.h"
+#include "MappedFile.h"
+#include "ParseDcm.h"
+#include "ThreadPool.h"
+
+namespace internal
+{
+  namespace
+  {
+    // Rough peak working set of one file relative to its size: the mapped
+    // text plus the decoded vertices, triangles and export buffers
+    constexpr std::uint64_t kWorkingSetFactor = 3;
+
+    // Counting gate on the number of files and bytes being converted
+    class InFlightBudget
+    {
+    public:
+      InFlightBudget(const std::size_t maxFiles, const std::uint64_t maxBytes)
+        : m_MaxFiles(maxFiles), m_MaxBytes(maxBytes)
+      {
+      }
+
+      void Acquire(const std::uint64_t bytes)
+      {
+        std::unique_lock lock(m_Mutex);
+        m_Released.wait(lock, [&] {
+          // Always admit a file when nothing runs, whatever its size
+          return m_Files == 0 || (m_Files < m_MaxFiles && m_Bytes + bytes <= m_MaxBytes);
+        });
+        ++m_Files;
+        m_Bytes += bytes;
+      }
+
+      void Release(const std::uint64_t bytes)
+      {
+        {
+          std::lock_guard lock(m_Mutex);
+          --m_Files;
+          m_Bytes -= bytes;
+        }
+        m_Released.notify_all();
+      }
+
+      // Bytes held outside any file (the buffers of idle parsers); they only
+      // delay admissions, a file is still admitted when nothing runs
+      void Hold(const std::uint64_t bytes)
+      {
+        std::lock_guard lock(m_Mutex);
+        m_Bytes += bytes;
+      }
+
+      void Unhold(const std::uint64_t bytes)
+      {
+        {
+          std::lock_guard lock(m_Mutex);
+          m_Bytes -= bytes;
+        }
+        m_Released.notify_all();
+      }
+
+      void WaitIdle()
+      {
+        std::unique_lock lock(m_Mutex);
+        m_Released.wait(lock, [&] { return m_Files == 0; });
+      }
+
+    private:
+      const std::size_t m_MaxFiles;
+      const std::uint64_t m_MaxBytes;
+      std::size_t m_Files{0};
+      std::uint64_t m_Bytes{0};
+      std::mutex m_Mutex;
+      std::condition_variable m_Released;
+    };
+
+    std::uint64_t EstimateWorkingSet(const std::filesystem::path& input)
+    {
+      std::error_code errorCode;
+      const auto size = std::filesystem::file_size(input, errorCode);
+      return errorCode ? 0 : static_cast<std::uint64_t>(size) * kWorkingSetFactor;
+    }
+
+    void ExportParsed(FileResult& result, const Open3SDCM::DCMParser& parser, const BatchOptions& options)
+    {
+      result.success = parser.ExportMesh(result.output, options.format, options.output);
+      result.stats.exports = parser.m_Stats.exports;
+      if (!result.success)
+      {
+        result.error = parser.m_Triangles.empty() ? "no mesh data" : "export failed";
+      }
+    }
+
+    // Parsers passed from file to file: a parser reuses the buffers of its previous
+    // parse, so a batch stops allocating once every parser has seen a large file.
+    // An idle parser keeps no result and at most options.retainedBufferBudget bytes
+    // of buffers, which count against `budget` when given.
+    class ParserPool
+    {
+    public:
+      explicit ParserPool(const Open3SDCM::ParseOptions& options, InFlightBudget* budget = nullptr)
+        : m_Options(options), m_Budget(budget)
+      {
+      }
+
+      std::unique_ptr<Open3SDCM::DCMParser> Acquire()
+      {
+        IdleParser idle;
+        {
+          std::lock_guard lock(m_Mutex);
+          if (m_Idle.empty())
+          {
+            return std::make_unique<Open3SDCM::DCMParser>();
+          }
+          idle = std::move(m_Idle.back());
+          m_Idle.pop_back();
+        }
+        // From here on the buffers are part of the file's working set
+        if (m_Budget != nullptr)
+        {
+          m_Budget->Unhold(idle.retainedBytes);
+        }
+        return std::move(idle.parser);
+      }
+
+      void Release(std::unique_ptr<Open3SDCM::DCMParser> parser)
+      {
+        if (!parser)
+        {
+          return;
+        }
+
+        parser->ResetResult(m_Options);
+        const std::uint64_t retainedBytes = parser->RetainedBufferBytes();
+        if (m_Budget != nullptr)
+        {
+          m_Budget->Hold(retainedBytes);
+        }
+        std::lock_guard lock(m_Mutex);
+        m_Idle.push_back({std::move(parser), retainedBytes});
+      }
+
+    private:
+      struct IdleParser
+      {
+        std::unique_ptr<Open3SDCM::DCMParser> parser;
+        std::uint64_t retainedBytes{0};
+      };
+
+      const Open3SDCM::ParseOptions& m_Options;
+      InFlightBudget* const m_Budget;
+      std::mutex m_Mutex;
+      std::vector<IdleParser> m_Idle;
+    };
+
+    void ConvertFile(FileResult& result, const BatchOptions& options, ParserPool& parsers)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      auto parser = parsers.Acquire();
+      try
+      {
+        parser->ParseDCM(result.input, options.parse);
+        result.vertexCount = parser->m_Vertices.size() / 3;
+        result.triangleCount = parser->m_Triangles.size();
+        result.stats = parser->m_Stats;
+        ExportParsed(result, *parser, options);
+      }
+      catch (const std::exception& ex)
+      {
+        result.success = false;
+        result.error = ex.what();
+      }
+      parsers.Release(std::move(parser));
+      result.elapsed = std::chrono::steady_clock::now() - start;
+    }
+
+    void ReportFile(const FileResult& result)
+    {
+      if (result.success)
+      {
+        O3SDCM_LOG_INFO("✓ {} -> {} ({} vertices, {} triangles, {:.2f} s)",
+                        result.input.filename().string(),
+                        result.output.string(),
+                        result.vertexCount,
+                        result.triangleCount,
+                        result.elapsed.count());
+      }
+      else
+      {
+        O3SDCM_LOG_ERROR("✗ {}: {}", result.input.string(), result.error);
+      }
+    }
+
+    // One file travelling through the pipeline. A failed stage records the error
+    // and passes the item on, so that the writer reports it and frees its budget.
+    struct PipelineItem
+    {
+      FileResult* result{nullptr};
+      std::uint64_t workingSet{0};
+      std::unique_ptr<Open3SDCM::detail::MappedFile> content;
+      std::unique_ptr<Open3SDCM::DCMParser> parser;
+    };
+
+    // Runs `step` and returns how long it took
+    template<typename Step>
+    std::chrono::duration<double> Timed(Step&& step)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      step();
+      return std::chrono::steady_clock::now() - start;
+    }
+
+    void ReadStage(PipelineItem& item, const bool collectStats)
+    {
+      try
+      {
+        const auto spent = Timed([&] {
+          item.content = std::make_unique<Open3SDCM::detail::MappedFile>(item.result->input);
+          item.content->Prefetch();
+        });
+        if (collectStats)
+        {
+          item.result->stats.fileRead = {spent.count(), item.content->Size(), 1};
+        }
+      }
+      catch (const Poco::Exception& ex)
+      {
+        item.result->error = ex.displayText();
+      }
+      catch (const std::exception& ex)
+      {
+        item.result->error = ex.what();
+      }
+    }
+
+    void DecodeStage(PipelineItem& item, const Open3SDCM::ParseOptions& parseOptions, ParserPool& parsers)
+    {
+      if (!item.content)
+      {
+        return;
+      }
+
+      try
+      {
+        item.parser = parsers.Acquire();
+        item.parser->ParseDCMBuffer(item.content->View(), item.result->input, parseOptions);
+        item.result->vertexCount = item.parser->m_Vertices.size() / 3;
+        item.result->triangleCount = item.parser->m_Triangles.size();
+        // The file was read by the previous stage
+        const Open3SDCM::StageTiming fileRead = item.result->stats.fileRead;
+        item.result->stats = item.parser->m_Stats;
+        item.result->stats.fileRead = fileRead;
+      }
+      catch (const std::exception& ex)
+      {
+        parsers.Release(std::move(item.parser));
+        item.result->error = ex.what();
+      }
+      // The decoded mesh no longer references the file
+      item.content.reset();
+    }
+
+    void ExportStage(PipelineItem& item, const BatchOptions& options, ParserPool& parsers)
+    {
+      if (!item.parser)
+      {
+        item.result->success = false;
+        return;
+      }
+
+      try
+      {
+        ExportParsed(*item.result, *item.parser, options);
+      }
+      catch (const std::exception& ex)
+      {
+        item.result->success = false;
+        item.result->error = ex.what();
+      }
+      parsers.Release(std::move(item.parser));
+    }
+
+    // read (1 thread) -> decode (`jobs` threads) -> export (1 thread)
+    std::vector<StageStats> ConvertPipelined(std::vector<FileResult>& results,
+                                             const BatchOptions& options,
+                                             const std::size_t jobs)
+    {
+      std::vector<StageStats> stages{{"read", 1}, {"decode", jobs}, {"export", 1}};
+      std::mutex statsMutex;
+      const auto record = [&](StageStats& stage, const StageStats& threadStats) {
+        std::lock_guard lock(statsMutex);
+        stage.busy += threadStats.busy;
+        stage.starved += threadStats.starved;
+        stage.blocked += threadStats.blocked;
+      };
+
+      const std::size_t maxFiles = options.maxInFlightFiles == 0 ? 2 * jobs + 2 : options.maxInFlightFiles;
+      InFlightBudget budget(maxFiles, options.maxInFlightBytes);
+      ParserPool parsers(options.parse, &budget);
+      BoundedQueue<PipelineItem> decodeQueue(jobs);
+      BoundedQueue<PipelineItem> exportQueue(jobs);
+
+      std::thread reader([&] {
+        StageStats stats;
+        for (auto& result : results)
+        {
+          PipelineItem item;
+          item.result = &result;
+          item.workingSet = EstimateWorkingSet(result.input);
+          // Waiting on the memory budget is backpressure from the later stages too
+          stats.blocked += Timed([&] { budget.Acquire(item.workingSet); });
+          const auto spent = Timed([&] { ReadStage(item, options.parse.collectStats); });
+          stats.busy += spent;
+          result.elapsed += spent;
+          stats.blocked += Timed([&] { decodeQueue.Push(std::move(item)); });
+        }
+        decodeQueue.Close();
+        record(stages[0], stats);
+      });
+
+      std::atomic<std::size_t> runningDecoders{jobs};
+      std::vector<std::thread> decoders;
+      decoders.reserve(jobs);
+      for (std::size_t i = 0; i < jobs; ++i)
+      {
+        decoders.emplace_back([&] {
+          StageStats stats;
+          for (;;)
+          {
+            std::optional<PipelineItem> item;
+            stats.starved += Timed([&] { item = decodeQueue.Pop(); });
+            if (!item)
+            {
+              break;
+            }
+            const auto spent = Timed([&] { DecodeStage(*item, options.parse, parsers); });
+            stats.busy += spent;
+            item->result->elapsed += spent;
+            stats.blocked += Timed([&] { exportQueue.Push(std::move(*item)); });
+          }
+          if (runningDecoders.fetch_sub(1) == 1)
+          {
+            exportQueue.Close();
+          }
+          record(stages[1], stats);
+        });
+      }
+
+      std::thread writer([&] {
+        StageStats stats;
+        for (;;)
+        {
+          std::optional<PipelineItem> item;
+          stats.starved += Timed([&] { item = exportQueue.Pop(); });
+          if (!item)
+          {
+            break;
+          }
+          const auto spent = Timed([&] { ExportStage(*item, options, parsers); });
+          stats.busy += spent;
+          item->result->elapsed += spent;
+          ReportFile(*item->result);
+          budget.Release(item->workingSet);
+        }
+        record(stages[2], stats);
+      });
+
+      reader.join();
+      for (auto& decoder : decoders)
+      {
+        decoder.join();
+      }
+      writer.join();
+      return stages;
+    }
+
+    std::string JsonString(const std::string& text)
+    {
+      std::string quoted = "\"";
+      for (const char c : text)
+      {
+        switch (c)
+        {
+          case '"': quoted += "\\\""; break;
+          case '\\': quoted += "\\\\"; break;
+          case '\n': quoted += "\\n"; break;
+          case '\r': quoted += "\\r"; break;
+          case '\t': quoted += "\\t"; break;
+          default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+              quoted += fmt::format("\\u{:04x}", static_cast<unsigned int>(c));
+            }
+            else
+            {
+              quoted += c;
+            }
+        }
+      }
+      quoted += '"';
+      return quoted;
+    }
+
+    std::string JsonTiming(const Open3SDCM::StageTiming& timing)
+    {
+      return fmt::format(R"({{"seconds": {}, "bytes": {}, "calls": {}}})", timing.seconds, timing.bytes, timing.calls);
+    }
+
+    std::string JsonParseStats(const Open3SDCM::ParseStats& stats)
+    {
+      const std::pair<const char*, const Open3SDCM::StageTiming*> stages[] = {{"file_read", &stats.fileRead},
+                                                                              {"cache_load", &stats.cacheLoad},
+                                                                              {"cache_store", &stats.cacheStore},
+                                                                              {"xml_parse", &stats.xmlParse},
+                                                                              {"base64_decode", &stats.base64Decode},
+                                                                              {"decrypt", &stats.decrypt},
+                                                                              {"checksum", &stats.checksum},
+                                                                              {"facet_decode", &stats.facetDecode},
+                                                                              {"uv_decode", &stats.uvDecode},
+                                                                              {"texture_decode", &stats.textureDecode}};
+      std::string json = fmt::format(R"({{"total_seconds": {}, "stages": {{)", stats.totalSeconds);
+      for (std::size_t i = 0; i < std::size(stages); ++i)
+      {
+        json += fmt::format(R"({}"{}": {})", i == 0 ? "" : ", ", stages[i].first, JsonTiming(*stages[i].second));
+      }
+      json += R"(}, "exports": {)";
+      bool first = true;
+      for (const auto& [format, timing] : stats.exports)
+      {
+        json += fmt::format("{}{}: {}", first ? "" : ", ", JsonString(format), JsonTiming(timing));
+        first = false;
+      }
+      json += fmt::format(R"(}}, "buffer_allocations": {}, "buffer_bytes": {}, "peak_buffer_bytes": {}}})",
+                          stats.bufferAllocations,
+                          stats.bufferBytes,
+                          stats.peakBufferBytes);
+      return json;
+    }
+  }// namespace
+
+  std::string OutputExtension(const std::string& format)
+  {
+    // Binary variants share the file extension of their format
+    if (format == "plyb")
+    {
+      return "ply";
+    }
+    if (format == "stlb")
+    {
+      return "stl";
+    }
+    return format;
+  }
+
+  std::vector<std::filesystem::path> AssignOutputPaths(const std::vector<std::filesystem::path>& inputs,
+                                                       const std::filesystem::path& outputDir,
+                                                       const std::string& format)
+  {
+    std::vector<std::filesystem::path> outputs;
+    outputs.reserve(inputs.size());
+    // Compared case-insensitively, for case-insensitive file systems
+    std::set<std::string> usedNames;
+    const auto claim = [&usedNames](const std::string& filename) {
+      std::string key = filename;
+      std::transform(key.begin(), key.end(), key.begin(), [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+      return usedNames.insert(std::move(key)).second;
+    };
+
+    const std::string extension = OutputExtension(format);
+    for (const auto& input : inputs)
+    {
+      const std::string stem = input.stem().string();
+      std::string filename = stem + "." + extension;
+      for (std::size_t suffix = 1; !claim(filename); ++suffix)
+      {
+        filename = fmt::format("{}_{}.{}", stem, suffix, extension);
+      }
+      outputs.push_back(outputDir / filename);
+    }
+    return outputs;
+  }
+
+  BatchSummary ConvertBatch(const std::vector<std::filesystem::path>& inputs, const BatchOptions& options)
+  {
+    const auto start = std::chrono::steady_clock::now();
+
+    BatchSummary summary;
+    summary.results.resize(inputs.size());
+    const auto outputs = AssignOutputPaths(inputs, options.outputDir, options.format);
+    for (std::size_t i = 0; i < inputs.size(); ++i)
+    {
+      summary.results[i].input = inputs[i];
+      summary.results[i].output = outputs[i];
+    }
+
+    const std::size_t jobs = options.jobs == 0 ? std::max(1U, std::thread::hardware_concurrency()) : options.jobs;
+    if (options.pipeline)
+    {
+      summary.stages = ConvertPipelined(summary.results, options, jobs);
+    }
+    else if (jobs == 1)
+    {
+      ParserPool parsers(options.parse);
+      for (auto& result : summary.results)
+      {
+        ConvertFile(result, options, parsers);
+        ReportFile(result);
+      }
+    }
+    else
+    {
+      const std::size_t maxFiles = options.maxInFlightFiles == 0 ? 2 * jobs : options.maxInFlightFiles;
+      InFlightBudget budget(maxFiles, options.maxInFlightBytes);
+      ParserPool parsers(options.parse, &budget);
+      std::mutex reportMutex;
+
+      Open3SDCM::detail::ThreadPool pool(jobs);
+      for (auto& result : summary.results)
+      {
+        const std::uint64_t workingSet = EstimateWorkingSet(result.input);
+        budget.Acquire(workingSet);
+        pool.Submit([&result, &budget, &reportMutex, &options, &parsers, workingSet] {
+          ConvertFile(result, options, parsers);
+          {
+            std::lock_guard lock(reportMutex);
+            ReportFile(result);
+          }
+          budget.Release(workingSet);
+        });
+      }
+      budget.WaitIdle();
+    }
+
+    for (const auto& result : summary.results)
+    {
+      ++(result.success ? summary.succeeded : summary.failed);
+    }
+    summary.elapsed = std::chrono::steady_clock::now() - start;
+    return summary;
+  }
+
+  void PrintSummary(const BatchSummary& summary)
+  {
+    const double seconds = summary.elapsed.count();
+    fmt::print("\nConverted {} of {} files in {:.2f} s ({:.2f} files/s)\n",
+               summary.succeeded,
+               summary.results.size(),
+               seconds,
+               seconds > 0.0 ? static_cast<double>(summary.results.size()) / seconds : 0.0);
+
+    if (!summary.stages.empty() && seconds > 0.0)
+    {
+      // Share of the stage's thread time (wall time x threads) spent in each state
+      fmt::print("Stage utilization:\n");
+      const StageStats* bottleneck = nullptr;
+      double bottleneckBusy = -1.0;
+      for (const auto& stage : summary.stages)
+      {
+        const double threadSeconds = seconds * static_cast<double>(stage.threads);
+        const double busy = stage.busy.count() / threadSeconds;
+        fmt::print("  {:<7} {:>2} thread(s): busy {:5.1f}%, waiting for input {:5.1f}%, waiting on next stage {:5.1f}%\n",
+                   stage.name,
+                   stage.threads,
+                   100.0 * busy,
+                   100.0 * stage.starved.count() / threadSeconds,
+                   100.0 * stage.blocked.count() / threadSeconds);
+        if (busy > bottleneckBusy)
+        {
+          bottleneck = &stage;
+          bottleneckBusy = busy;
+        }
+      }
+      if (bottleneck != nullptr)
+      {
+        const char* kind = bottleneck->name == "read" ? "I/O-bound" : bottleneck->name == "decode" ? "CPU-bound" : "output-bound";
+        fmt::print("Busiest stage: {} ({})\n", bottleneck->name, kind);
+      }
+    }
+
+    if (summary.failed > 0)
+    {
+      fmt::print("{} file(s) failed:\n", summary.failed);
+      for (const auto& result : summary.results)
+      {
+        if (!result.success)
+        {
+          fmt::print("  {}: {}\n", result.input.string(), result.error);
+        }
+      }
+    }
+  }
+
+  bool WriteStatsJson(const BatchSummary& summary, const std::filesystem::path& path)
+  {
+    std::string json = fmt::format("{{\n  \"elapsed_seconds\": {},\n  \"files\": [", summary.elapsed.count());
+    for (std::size_t i = 0; i < summary.results.size(); ++i)
+    {
+      const FileResult& result = summary.results[i];
+      json += fmt::format(R"({}
+    {{"input": {}, "output": {}, "success": {}, "error": {}, "vertices": {}, "triangles": {}, "seconds": {}, "stats": {}}})",
+                          i == 0 ? "" : ",",
+                          JsonString(result.input.string()),
+                          JsonString(result.output.string()),
+                          result.success,
+                          JsonString(result.error),
+                          result.vertexCount,
+                          result.triangleCount,
+                          result.elapsed.count(),
+                          JsonParseStats(result.stats));
+    }
+    json += "\n  ]\n}\n";
+
+    std::ofstream output(path, std::ios::binary);
+    output.write(json.data(), static_cast<std::streamsize>(json.size()));
+    return static_cast<bool>(output);
+  }
+}// namespace internal
@@ -0,0 +1,85 @@
+//
+// Concurrent conversion of many DCM files for the CLI directory mode.
+//
+
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "definitions.h"
+
+namespace internal
+{
+  struct BatchOptions
+  {
+    std::filesystem::path outputDir;
+    std::string format{"stl"};
+    std::size_t jobs{1};                                   // concurrent files, 0 = one per core
+    std::size_t maxInFlightFiles{0};                       // 0 = 2 * jobs (+ 2 in pipeline mode)
+    std::uint64_t maxInFlightBytes{4ULL * 1024 * 1024 * 1024};// estimated working set of the files in flight
+    bool pipeline{false};                                  // read, decode and export in separate stages
+    Open3SDCM::ParseOptions parse;                         // per-file decode scheduling
+    Open3SDCM::ExportOptions output;                       // exporter settings (float precision)
+  };
+
+  struct FileResult
+  {
+    std::filesystem::path input;
+    std::filesystem::path output;
+    bool success{false};
+    std::string error;
+    std::size_t vertexCount{0};
+    std::size_t triangleCount{0};
+    std::chrono::duration<double> elapsed{0};
+    Open3SDCM::ParseStats stats;// filled when options.parse.collectStats is set
+  };
+
+  // Where the threads of one pipeline stage spent their time, summed over the threads
+  struct StageStats
+  {
+    std::string name;
+    std::size_t threads{0};
+    std::chrono::duration<double> busy{0};   // reading, decoding or exporting
+    std::chrono::duration<double> starved{0};// waiting for the previous stage
+    std::chrono::duration<double> blocked{0};// waiting for room in the next stage (backpressure)
+  };
+
+  struct BatchSummary
+  {
+    std::vector<FileResult> results;// same order as the input files
+    std::size_t succeeded{0};
+    std::size_t failed{0};
+    std::chrono::duration<double> elapsed{0};
+    std::vector<StageStats> stages;// pipeline mode only: read, decode, export
+  };
+
+  // File extension written for an output format (plyb -> ply, stlb -> stl)
+  std::string OutputExtension(const std::string& format);
+
+  // One output path per input, in input order: <stem>.<ext>, and
+  // <stem>_<n>.<ext> for the n-th later input with an already used name
+  // (e.g. same file name in different sub-directories). Only depends on the
+  // input list, not on the processing order.
+  std::vector<std::filesystem::path> AssignOutputPaths(const std::vector<std::filesystem::path>& inputs,
+                                                       const std::filesystem::path& outputDir,
+                                                       const std::string& format);
+
+  // Parses and exports every input, `jobs` files at a time on a work-stealing
+  // pool. Files are admitted in input order while the in-flight file count and
+  // estimated memory stay within the options' bounds (a file larger than the
+  // memory bound still runs, alone).
+  // In pipeline mode a reader thread maps and prefetches the next files, `jobs`
+  // threads decode them and a writer thread exports them, the stages being
+  // connected by bounded queues; the summary then carries per-stage statistics.
+  BatchSummary ConvertBatch(const std::vector<std::filesystem::path>& inputs, const BatchOptions& options);
+
+  void PrintSummary(const BatchSummary& summary);
+
+  // Per-file results and parse stage timings as one JSON document; returns false if
+  // `path` cannot be written
+  bool WriteStatsJson(const BatchSummary& summary, const std::filesystem::path& path);
+}// namespace internal
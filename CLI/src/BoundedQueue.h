@@ -0,0 +1,78 @@
+//
+// Blocking FIFO of bounded capacity connecting the stages of the CLI pipeline.
+//
+
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace internal
+{
+  // Push blocks while the queue is full (backpressure on the producer), Pop blocks
+  // while it is empty. Once closed, Push refuses new items and Pop drains the
+  // remaining ones, then returns std::nullopt.
+  template<typename T>
+  class BoundedQueue
+  {
+  public:
+    explicit BoundedQueue(const std::size_t capacity)
+      : m_Capacity(capacity == 0 ? 1 : capacity)
+    {
+    }
+
+    // Returns false, without taking the item, if the queue was closed
+    bool Push(T item)
+    {
+      {
+        std::unique_lock lock(m_Mutex);
+        m_NotFull.wait(lock, [this] { return m_Closed || m_Items.size() < m_Capacity; });
+        if (m_Closed)
+        {
+          return false;
+        }
+        m_Items.push_back(std::move(item));
+      }
+      m_NotEmpty.notify_one();
+      return true;
+    }
+
+    std::optional<T> Pop()
+    {
+      std::optional<T> item;
+      {
+        std::unique_lock lock(m_Mutex);
+        m_NotEmpty.wait(lock, [this] { return m_Closed || !m_Items.empty(); });
+        if (m_Items.empty())
+        {
+          return std::nullopt;// closed and drained
+        }
+        item.emplace(std::move(m_Items.front()));
+        m_Items.pop_front();
+      }
+      m_NotFull.notify_one();
+      return item;
+    }
+
+    void Close()
+    {
+      {
+        std::lock_guard lock(m_Mutex);
+        m_Closed = true;
+      }
+      m_NotFull.notify_all();
+      m_NotEmpty.notify_all();
+    }
+
+  private:
+    const std::size_t m_Capacity;
+    std::deque<T> m_Items;
+    bool m_Closed{false};
+    std::mutex m_Mutex;
+    std::condition_variable m_NotFull;
+    std::condition_variable m_NotEmpty;
+  };
+}// namespace internal
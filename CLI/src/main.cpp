@@ -17,7 +17,9 @@
 #include "Poco/Zip/ZipArchive.h"
 
 
+#include "Log.h"
 #include "ParseDcm.h"
+#include "BatchConverter.h"
 
 namespace po = boost::program_options;
 namespace fs = std::filesystem;
@@ -29,14 +31,14 @@ namespace internal
   std::vector<std::filesystem::path> PopulateFiles(const std::filesystem::path& iDir)
   {
     std::vector<std::filesystem::path> AllInFiles;
-    fmt::print("Looking for dir ...\n");
+    O3SDCM_LOG_DEBUG("Looking for dir ...");
     for (const fs::directory_entry& dir_entry:
          fs::recursive_directory_iterator(iDir))
     {
 
       if (!dir_entry.path().filename().string().starts_with('.'))
       {
-        fmt::print("Found file extension: {}\n", dir_entry.path().extension().string());
+        O3SDCM_LOG_DEBUG("Found file extension: {}", dir_entry.path().extension().string());
         if(fs::is_regular_file(dir_entry.path()) &&
           std::any_of(AcceptedDCMExtensions.begin(), AcceptedDCMExtensions.end(),
             [&](const auto & accepted_extension) {
@@ -86,7 +88,16 @@ int main(int argc, const char** argv)
         ("action", po::value<std::string>(), "what to do")
           ("input,i", po::value<std::filesystem::path>(), "input file or directory")
             ("output_dir,o", po::value<std::filesystem::path>(), "output directory")
-              ("format,f", po::value<std::string>(), "output format stl,ply,obj")
+              ("format,f", po::value<std::string>(), "output format stl,stlb,ply,plyb,obj,glb")
+                ("jobs,j", po::value<std::size_t>()->default_value(1), "number of files converted concurrently (0 = one per core)")
+                  ("max_inflight_mb", po::value<std::size_t>()->default_value(4096), "memory bound (MB) for the files being converted at once")
+                  ("parser_buffer_mb", po::value<std::size_t>()->default_value(256), "decode buffers (MB) each parser keeps for the next file (0 = no bound)")
+                  ("pipeline", "overlap reading, decoding and writing of files, and report per-stage utilization")
+                  ("precision", po::value<int>()->default_value(0), "significant digits of floats in text formats (0 = shortest exact)")
+                  ("dedup_uvs", "OBJ: write each distinct texture coordinate once instead of once per triangle corner")
+                  ("cache_dir", po::value<std::filesystem::path>(), "reuse decoded meshes stored in this directory; unchanged DCMs skip decoding")
+                  ("log_level", po::value<std::string>()->default_value("info"), "trace, debug, info (one line per file), warn, error, critical or off")
+                  ("stats", po::value<std::string>(), "time every decode and export stage per file; json writes stats.json to the output directory")
                   ;
 
   po::variables_map vm;
@@ -103,14 +114,37 @@ int main(int argc, const char** argv)
     fmt::print("    Open3SDCMCLI -i input.dcm -o output_dir -f stl\n\n");
     fmt::print("  Convert all DCM files in a directory:\n");
     fmt::print("    Open3SDCMCLI -i input_dir -o output_dir -f ply\n\n");
+    fmt::print("  Convert a directory using all cores:\n");
+    fmt::print("    Open3SDCMCLI -i input_dir -o output_dir -f ply -j 0\n\n");
+    fmt::print("  Convert a directory with read, decode and write running in parallel stages:\n");
+    fmt::print("    Open3SDCMCLI -i input_dir -o output_dir -f ply -j 4 --pipeline\n\n");
+    fmt::print("  Re-convert a directory, decoding only the files changed since the last run:\n");
+    fmt::print("    Open3SDCMCLI -i input_dir -o output_dir -f glb --cache_dir dcm_cache\n\n");
+    fmt::print("  Find where a batch spends its time, per file and per stage:\n");
+    fmt::print("    Open3SDCMCLI -i input_dir -o output_dir -f stlb -j 0 --stats json\n\n");
     return 1;
   }
+  if (vm.count("stats") && vm["stats"].as<std::string>() != "json")
+  {
+    fmt::print("/!\\ Unsupported stats format {} (expected json)\n", vm["stats"].as<std::string>());
+    return 1;
+  }
+  const std::string LogLevelName = vm["log_level"].as<std::string>();
+  const spdlog::level::level_enum LogLevel = spdlog::level::from_str(LogLevelName);
+  if (LogLevel == spdlog::level::off && LogLevelName != "off")
+  {
+    fmt::print("/!\\ Unknown log level {}\n", LogLevelName);
+    return 1;
+  }
+  // The library is silent until given a logger; files converted in parallel log through one background thread
+  Open3SDCM::SetLogger(Open3SDCM::MakeAsyncStderrLogger(LogLevel));
+
   std::string OutputFormat("stl");
   if (vm.count("format"))
   {
     OutputFormat=vm["format"].as<std::string>();
   }
-  fmt::print("Output Format Mode {}\n", OutputFormat);
+  O3SDCM_LOG_INFO("Output Format Mode {}", OutputFormat);
 
   std::vector<std::filesystem::path> AllInFiles;
   if (vm.count("input"))
@@ -126,7 +160,7 @@ int main(int argc, const char** argv)
     if (fs::is_regular_file(InputPath))
     {
       // Single file mode
-      fmt::print("Input file: {}\n", InputPath.string());
+      O3SDCM_LOG_INFO("Input file: {}", InputPath.string());
       if (std::any_of(AcceptedDCMExtensions.begin(), AcceptedDCMExtensions.end(),
           [&](const auto& accepted_extension) {
             return accepted_extension == InputPath.extension().string();
@@ -143,8 +177,10 @@ int main(int argc, const char** argv)
     else if (fs::is_directory(InputPath))
     {
       // Directory mode
-      fmt::print("Input directory: {}\n", InputPath.string());
+      O3SDCM_LOG_INFO("Input directory: {}", InputPath.string());
       AllInFiles = internal::PopulateFiles(InputPath);
+      // Directory iteration order is unspecified; sort for reproducible output names
+      std::sort(AllInFiles.begin(), AllInFiles.end());
     }
     else
     {
@@ -152,7 +188,7 @@ int main(int argc, const char** argv)
       return 1;
     }
 
-    fmt::print("Found {} files \n", AllInFiles.size());
+    O3SDCM_LOG_INFO("Found {} files", AllInFiles.size());
   }
   else
   {
@@ -172,38 +208,46 @@ int main(int argc, const char** argv)
     bool CreateDir = fs::create_directories(OutputDir);
     if (CreateDir)
     {
-      fmt::print("output_dir {} Succesfully created\n", OutputDir.string());
+      O3SDCM_LOG_INFO("output_dir {} Succesfully created", OutputDir.string());
     }
     else
     {
-      fmt::print("output_dir {}\n", OutputDir.string());
+      O3SDCM_LOG_INFO("output_dir {}", OutputDir.string());
     }
   }
 
-  for (const auto& inputFile : AllInFiles)
+  internal::BatchOptions Options;
+  Options.outputDir = OutputDir;
+  Options.format = OutputFormat;
+  Options.jobs = vm["jobs"].as<std::size_t>();
+  Options.maxInFlightBytes = static_cast<std::uint64_t>(vm["max_inflight_mb"].as<std::size_t>()) * 1024 * 1024;
+  Options.pipeline = vm.count("pipeline") > 0;
+  Options.output.floatPrecision = vm["precision"].as<int>();
+  Options.output.deduplicateTextureCoordinates = vm.count("dedup_uvs") > 0;
+  // A single file gets the whole machine: decode its payloads concurrently
+  Options.parse.concurrentDecode = AllInFiles.size() == 1;
+  if (vm.count("cache_dir"))
   {
-    Open3SDCM::DCMParser Parser;
-    Parser.ParseDCM(inputFile);
-
-    fmt::print("Parsed {} vertices and {} triangles from {}\n",
-               Parser.m_Vertices.size() / 3,
-               Parser.m_Triangles.size(),
-               inputFile.filename().string());
+    Options.parse.cacheDirectory = vm["cache_dir"].as<std::filesystem::path>();
+  }
+  Options.parse.collectStats = vm.count("stats") > 0;
+  Options.parse.retainedBufferBudget = vm["parser_buffer_mb"].as<std::size_t>() * 1024 * 1024;
 
-    // Generate output filename
-    std::string outputFilename = inputFile.stem().string() + "." + OutputFormat;
-    std::filesystem::path outputFilePath = OutputDir / outputFilename;
+  const internal::BatchSummary Summary = internal::ConvertBatch(AllInFiles, Options);
+  // Let the queued per-file lines out before the summary
+  Open3SDCM::ShutdownLogging();
+  internal::PrintSummary(Summary);
 
-    // Export mesh
-    if (Parser.ExportMesh(outputFilePath, OutputFormat))
-    {
-      fmt::print("✓ Successfully exported to: {}\n\n", outputFilePath.string());
-    }
-    else
+  if (Options.parse.collectStats)
+  {
+    const std::filesystem::path StatsPath = OutputDir / "stats.json";
+    if (!internal::WriteStatsJson(Summary, StatsPath))
     {
-      fmt::print("✗ Failed to export {}\n\n", outputFilename);
+      fmt::print("/!\\ Cannot write stats to {}\n", StatsPath.string());
+      return 1;
     }
+    fmt::print("Stats written to {}\n", StatsPath.string());
   }
 
-  return 0;
+  return Summary.failed == 0 ? 0 : 1;
 }
@@ -0,0 +1,403 @@
+//
+// Vectorized base64 decoding for the DCM binary payloads.
+//
+// The vector kernels follow the nibble-lookup scheme of Muła & Lemire
+// ("Faster Base64 Encoding and Decoding using AVX2 Instructions", 2018):
+// every input byte is classified and translated with two 16-entry lookups
+// on its high and low nibble, then four 6-bit values are packed into three
+// bytes with multiply-add instructions (x86) or a de-interleaving load (NEON).
+// A block containing anything else than the 64 alphabet characters (line
+// breaks, padding, garbage) is left to the scalar path, which consumes one
+// 4-character quantum at a time, then the vector path resumes.
+//
+
+#include "Base64.h"
+
+#include <array>
+
+#include <Poco/Exception.h>
+#include <fmt/format.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define OPEN3SDCM_BASE64_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define OPEN3SDCM_TARGET(isa)
+#else
+#define OPEN3SDCM_TARGET(isa) __attribute__((target(isa)))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define OPEN3SDCM_BASE64_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace Open3SDCM::detail::base64
+{
+  namespace
+  {
+    constexpr std::uint8_t kWhitespace = 0x40;
+    constexpr std::uint8_t kPadding = 0x41;
+    constexpr std::uint8_t kInvalid = 0xFF;
+
+    constexpr std::array<std::uint8_t, 256> BuildDecodeTable()
+    {
+      std::array<std::uint8_t, 256> table{};
+      table.fill(kInvalid);
+      constexpr std::string_view alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+      for (std::size_t i = 0; i < alphabet.size(); ++i)
+      {
+        table[static_cast<unsigned char>(alphabet[i])] = static_cast<std::uint8_t>(i);
+      }
+      table[' '] = kWhitespace;
+      table['\t'] = kWhitespace;
+      table['\r'] = kWhitespace;
+      table['\n'] = kWhitespace;
+      table['='] = kPadding;
+      return table;
+    }
+
+    constexpr std::array<std::uint8_t, 256> kDecodeTable = BuildDecodeTable();
+
+    // Decodes one quantum, skipping whitespace. Returns false once the input
+    // is exhausted or padding was reached; a trailing partial quantum is still
+    // written in that case.
+    bool DecodeQuantum(const char*& in, const char* end, std::uint8_t*& out, bool& finished)
+    {
+      std::uint32_t bits = 0;
+      int symbols = 0;
+      while (symbols < 4)
+      {
+        if (in == end)
+        {
+          finished = true;
+          break;
+        }
+
+        const auto c = static_cast<unsigned char>(*in);
+        const std::uint8_t value = kDecodeTable[c];
+        if (value < 64)
+        {
+          bits = (bits << 6U) | value;
+          ++symbols;
+          ++in;
+        }
+        else if (value == kWhitespace)
+        {
+          ++in;
+        }
+        else if (value == kPadding)
+        {
+          finished = true;
+          break;
+        }
+        else
+        {
+          throw Poco::DataFormatException(fmt::format("Invalid base64 character 0x{:02X}", c));
+        }
+      }
+
+      switch (symbols)
+      {
+        case 4:
+          out[0] = static_cast<std::uint8_t>(bits >> 16U);
+          out[1] = static_cast<std::uint8_t>(bits >> 8U);
+          out[2] = static_cast<std::uint8_t>(bits);
+          out += 3;
+          return !finished;
+        case 3:
+          out[0] = static_cast<std::uint8_t>(bits >> 10U);
+          out[1] = static_cast<std::uint8_t>(bits >> 2U);
+          out += 2;
+          break;
+        case 2:
+          out[0] = static_cast<std::uint8_t>(bits >> 4U);
+          out += 1;
+          break;
+        default:
+          break;
+      }
+      return false;
+    }
+
+    const char* FindNonAlphabet(const char* in, const char* end)
+    {
+      while (in != end && kDecodeTable[static_cast<unsigned char>(*in)] < 64)
+      {
+        ++in;
+      }
+      return in;
+    }
+
+#if defined(OPEN3SDCM_BASE64_X86)
+    OPEN3SDCM_TARGET("avx2")
+    void DecodeBlocksAvx2(const char*& in, const char* end, std::uint8_t*& out, const std::uint8_t* outLimit)
+    {
+      const __m256i lutLo = _mm256_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+      const __m256i lutHi = _mm256_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+      const __m256i lutRoll = _mm256_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+      const __m256i mask2F = _mm256_set1_epi8(0x2F);
+      const __m256i mergeSextets = _mm256_set1_epi32(0x01400140);
+      const __m256i mergePairs = _mm256_set1_epi32(0x00011000);
+      const __m256i packBytes = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+      const __m256i packLanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1);
+
+      while (end - in >= 32 && outLimit - out >= 24)
+      {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+        const __m256i hiNibbles = _mm256_and_si256(_mm256_srli_epi32(chunk, 4), mask2F);
+        const __m256i loNibbles = _mm256_and_si256(chunk, mask2F);
+        const __m256i lo = _mm256_shuffle_epi8(lutLo, loNibbles);
+        const __m256i hi = _mm256_shuffle_epi8(lutHi, hiNibbles);
+        if (!_mm256_testz_si256(lo, hi))
+        {
+          break;
+        }
+
+        const __m256i eq2F = _mm256_cmpeq_epi8(chunk, mask2F);
+        const __m256i roll = _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(eq2F, hiNibbles));
+        const __m256i sextets = _mm256_add_epi8(chunk, roll);
+        const __m256i pairs = _mm256_maddubs_epi16(sextets, mergeSextets);
+        const __m256i triplets = _mm256_madd_epi16(pairs, mergePairs);
+        const __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(triplets, packBytes), packLanes);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), bytes);
+
+        in += 32;
+        out += 24;
+      }
+    }
+
+    OPEN3SDCM_TARGET("ssse3,sse4.1")
+    void DecodeBlocksSse41(const char*& in, const char* end, std::uint8_t*& out, const std::uint8_t* outLimit)
+    {
+      const __m128i lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+      const __m128i lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+      const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+      const __m128i mask2F = _mm_set1_epi8(0x2F);
+      const __m128i mergeSextets = _mm_set1_epi32(0x01400140);
+      const __m128i mergePairs = _mm_set1_epi32(0x00011000);
+      const __m128i packBytes = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+      while (end - in >= 16 && outLimit - out >= 12)
+      {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+        const __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(chunk, 4), mask2F);
+        const __m128i loNibbles = _mm_and_si128(chunk, mask2F);
+        const __m128i lo = _mm_shuffle_epi8(lutLo, loNibbles);
+        const __m128i hi = _mm_shuffle_epi8(lutHi, hiNibbles);
+        if (!_mm_testz_si128(lo, hi))
+        {
+          break;
+        }
+
+        const __m128i eq2F = _mm_cmpeq_epi8(chunk, mask2F);
+        const __m128i roll = _mm_shuffle_epi8(lutRoll, _mm_add_epi8(eq2F, hiNibbles));
+        const __m128i sextets = _mm_add_epi8(chunk, roll);
+        const __m128i pairs = _mm_maddubs_epi16(sextets, mergeSextets);
+        const __m128i triplets = _mm_madd_epi16(pairs, mergePairs);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_shuffle_epi8(triplets, packBytes));
+
+        in += 16;
+        out += 12;
+      }
+    }
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    bool CpuHas(const Isa isa)
+    {
+      int info[4] = {};
+      __cpuid(info, 0);
+      const int maxLeaf = info[0];
+      __cpuid(info, 1);
+      const bool sse41 = (info[2] & (1 << 19)) != 0 && (info[2] & (1 << 9)) != 0;
+      if (isa == Isa::Sse41)
+      {
+        return sse41;
+      }
+
+      // AVX2 also needs the OS to save the YMM registers
+      const bool osxsave = (info[2] & (1 << 27)) != 0;
+      if (!osxsave || maxLeaf < 7 || (_xgetbv(0) & 0x6U) != 0x6U)
+      {
+        return false;
+      }
+      __cpuidex(info, 7, 0);
+      return (info[1] & (1 << 5)) != 0;
+    }
+#else
+    bool CpuHas(const Isa isa)
+    {
+      __builtin_cpu_init();
+      if (isa == Isa::Sse41)
+      {
+        return __builtin_cpu_supports("ssse3") && __builtin_cpu_supports("sse4.1");
+      }
+      return __builtin_cpu_supports("avx2");
+    }
+#endif
+#endif// OPEN3SDCM_BASE64_X86
+
+#if defined(OPEN3SDCM_BASE64_NEON)
+    void DecodeBlocksNeon(const char*& in, const char* end, std::uint8_t*& out, const std::uint8_t* outLimit)
+    {
+      static constexpr std::uint8_t kLutLo[16] = {0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A};
+      static constexpr std::uint8_t kLutHi[16] = {0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10};
+      static constexpr std::uint8_t kLutRoll[16] = {0, 16, 19, 4, 191, 191, 185, 185, 0, 0, 0, 0, 0, 0, 0, 0};
+      const uint8x16_t lutLo = vld1q_u8(kLutLo);
+      const uint8x16_t lutHi = vld1q_u8(kLutHi);
+      const uint8x16_t lutRoll = vld1q_u8(kLutRoll);
+      const uint8x16_t lowNibbleMask = vdupq_n_u8(0x0F);
+      const uint8x16_t slash = vdupq_n_u8(0x2F);
+
+      // 64 characters are de-interleaved into the four symbols of 16 quanta
+      while (end - in >= 64 && outLimit - out >= 48)
+      {
+        const uint8x16x4_t chunk = vld4q_u8(reinterpret_cast<const std::uint8_t*>(in));
+        uint8x16_t invalid = vdupq_n_u8(0);
+        uint8x16_t sextets[4];
+        for (int i = 0; i < 4; ++i)
+        {
+          const uint8x16_t hiNibbles = vshrq_n_u8(chunk.val[i], 4);
+          const uint8x16_t loNibbles = vandq_u8(chunk.val[i], lowNibbleMask);
+          invalid = vorrq_u8(invalid, vandq_u8(vqtbl1q_u8(lutLo, loNibbles), vqtbl1q_u8(lutHi, hiNibbles)));
+          const uint8x16_t eq2F = vceqq_u8(chunk.val[i], slash);
+          sextets[i] = vaddq_u8(chunk.val[i], vqtbl1q_u8(lutRoll, vaddq_u8(eq2F, hiNibbles)));
+        }
+        if (vmaxvq_u8(invalid) != 0)
+        {
+          break;
+        }
+
+        uint8x16x3_t bytes;
+        bytes.val[0] = vorrq_u8(vshlq_n_u8(sextets[0], 2), vshrq_n_u8(sextets[1], 4));
+        bytes.val[1] = vorrq_u8(vshlq_n_u8(sextets[1], 4), vshrq_n_u8(sextets[2], 2));
+        bytes.val[2] = vorrq_u8(vshlq_n_u8(sextets[2], 6), sextets[3]);
+        vst3q_u8(out, bytes);
+
+        in += 64;
+        out += 48;
+      }
+    }
+#endif// OPEN3SDCM_BASE64_NEON
+
+    void DecodeBlocks(const Isa isa, const char*& in, const char* end, std::uint8_t*& out, const std::uint8_t* outLimit)
+    {
+      switch (isa)
+      {
+#if defined(OPEN3SDCM_BASE64_X86)
+        case Isa::Avx2:
+          DecodeBlocksAvx2(in, end, out, outLimit);
+          break;
+        case Isa::Sse41:
+          DecodeBlocksSse41(in, end, out, outLimit);
+          break;
+#endif
+#if defined(OPEN3SDCM_BASE64_NEON)
+        case Isa::Neon:
+          DecodeBlocksNeon(in, end, out, outLimit);
+          break;
+#endif
+        default:
+          break;
+      }
+    }
+
+    Isa DetectIsa()
+    {
+      if (IsSupported(Isa::Avx2)) return Isa::Avx2;
+      if (IsSupported(Isa::Neon)) return Isa::Neon;
+      if (IsSupported(Isa::Sse41)) return Isa::Sse41;
+      return Isa::Scalar;
+    }
+  }// namespace
+
+  bool IsSupported(const Isa isa)
+  {
+    switch (isa)
+    {
+      case Isa::Scalar:
+        return true;
+#if defined(OPEN3SDCM_BASE64_X86)
+      case Isa::Sse41:
+      case Isa::Avx2: {
+        static const bool hasSse41 = CpuHas(Isa::Sse41);
+        static const bool hasAvx2 = CpuHas(Isa::Avx2);
+        return isa == Isa::Avx2 ? hasAvx2 : hasSse41;
+      }
+#endif
+#if defined(OPEN3SDCM_BASE64_NEON)
+      case Isa::Neon:
+        return true;
+#endif
+      default:
+        return false;
+    }
+  }
+
+  Isa ActiveIsa()
+  {
+    static const Isa isa = DetectIsa();
+    return isa;
+  }
+
+  std::string_view IsaName(const Isa isa)
+  {
+    switch (isa)
+    {
+      case Isa::Scalar: return "scalar";
+      case Isa::Sse41: return "sse4.1";
+      case Isa::Avx2: return "avx2";
+      case Isa::Neon: return "neon";
+    }
+    return "unknown";
+  }
+
+  StreamDecoder::StreamDecoder(std::string_view encoded, const Isa isa)
+    : m_Input(encoded.data()),
+      m_End(encoded.data() + encoded.size()),
+      m_Isa(IsSupported(isa) ? isa : Isa::Scalar)
+  {
+  }
+
+  std::size_t StreamDecoder::Read(std::uint8_t* out, const std::size_t maxBytes)
+  {
+    std::uint8_t* const outStart = out;
+    const std::uint8_t* const outLimit = out + maxBytes;
+
+    while (!m_Finished && outLimit - out >= 3)
+    {
+      DecodeBlocks(m_Isa, m_Input, m_End, out, outLimit);
+      if (outLimit - out < 3)
+      {
+        break;
+      }
+
+      // The vector block stopped at a line break, padding or a bad character:
+      // finish the text up to and including it one quantum at a time
+      const char* const stop = FindNonAlphabet(m_Input, m_End);
+      while (!m_Finished && m_Input <= stop && outLimit - out >= 3)
+      {
+        if (!DecodeQuantum(m_Input, m_End, out, m_Finished))
+        {
+          m_Finished = true;
+        }
+      }
+    }
+
+    return static_cast<std::size_t>(out - outStart);
+  }
+
+  std::size_t Decode(std::string_view encoded, std::uint8_t* out, const Isa isa)
+  {
+    StreamDecoder decoder(encoded, isa);
+    return decoder.Read(out, MaxDecodedSize(encoded.size()));
+  }
+}// namespace Open3SDCM::detail::base64
@@ -0,0 +1,63 @@
+//
+// Vectorized base64 decoding for the DCM binary payloads.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace Open3SDCM::detail::base64
+{
+  // Instruction sets the decoder has kernels for. The best one available on the
+  // running CPU is picked once at runtime; Scalar is always available.
+  enum class Isa
+  {
+    Scalar,
+    Sse41,
+    Avx2,
+    Neon
+  };
+
+  // The vector kernels store whole registers, so output buffers need this much
+  // writable space past the decoded data.
+  inline constexpr std::size_t kOutputSlack = 32;
+
+  // Upper bound of the decoded size of `encodedSize` characters of base64 text
+  constexpr std::size_t MaxDecodedSize(const std::size_t encodedSize)
+  {
+    return (encodedSize / 4U) * 3U + 3U;
+  }
+
+  [[nodiscard]] bool IsSupported(Isa isa);
+  [[nodiscard]] Isa ActiveIsa();
+  [[nodiscard]] std::string_view IsaName(Isa isa);
+
+  // Incremental decoder. Whitespace (space, tab, CR, LF) is skipped inline,
+  // decoding stops at the first '=' padding character, and any other character
+  // outside the base64 alphabet raises Poco::DataFormatException.
+  class StreamDecoder
+  {
+  public:
+    explicit StreamDecoder(std::string_view encoded, Isa isa = ActiveIsa());
+
+    // Decodes up to `maxBytes` more bytes into `out`, which must provide
+    // maxBytes + kOutputSlack writable bytes. Returns the number of bytes written;
+    // a return value below maxBytes (rounded down to a multiple of 3) means the
+    // input is exhausted.
+    std::size_t Read(std::uint8_t* out, std::size_t maxBytes);
+
+    [[nodiscard]] bool AtEnd() const { return m_Finished || m_Input == m_End; }
+
+  private:
+    const char* m_Input;
+    const char* m_End;
+    Isa m_Isa;
+    bool m_Finished{false};
+  };
+
+  // Decodes all of `encoded` into `out`, which must provide
+  // MaxDecodedSize(encoded.size()) + kOutputSlack writable bytes.
+  // Returns the decoded size.
+  std::size_t Decode(std::string_view encoded, std::uint8_t* out, Isa isa = ActiveIsa());
+}// namespace Open3SDCM::detail::base64
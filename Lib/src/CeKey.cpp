@@ -0,0 +1,168 @@
+//
+// CE schema Blowfish key derivation and the process-wide key schedule cache.
+//
+
+#include "CeKey.h"
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+
+#include <openssl/md5.h>
+
+namespace Open3SDCM::detail
+{
+  namespace
+  {
+    constexpr std::array<unsigned char, 16> kCeBaseKey = {
+      0x34, 0x90, 0x02, 0x93, 0x58, 0x2F, 0x49, 0x94,
+      0x76, 0x02, 0x19, 0xDF, 0x3B, 0x56, 0x44, 0x1C
+    };
+
+    std::string_view GetEkid(const PropertyMap& props)
+    {
+      const auto ekidIt = props.find("EKID");
+      return ekidIt != props.end() ? std::string_view(ekidIt->second) : std::string_view("1");
+    }
+
+    std::string_view GetPackageLockList(const PropertyMap& props)
+    {
+      const auto it = props.find("PackageLockList");
+      return it != props.end() ? std::string_view(it->second) : std::string_view();
+    }
+
+    std::string HashCanonicalLockList(const std::string& canonical)
+    {
+      if (canonical.empty())
+      {
+        return "";
+      }
+
+      unsigned char digest[MD5_DIGEST_LENGTH];
+      MD5(reinterpret_cast<const unsigned char*>(canonical.data()), canonical.size(), digest);
+
+      constexpr std::string_view hexDigits = "0123456789ABCDEF";
+      std::string hex;
+      hex.reserve(2 * MD5_DIGEST_LENGTH);
+      for (const unsigned char byte : digest)
+      {
+        hex.push_back(hexDigits[byte >> 4U]);
+        hex.push_back(hexDigits[byte & 0x0FU]);
+      }
+      return hex;
+    }
+
+    std::vector<unsigned char> BuildCeKey(std::string_view ekid, const std::string& canonicalLockList, const bool scramble)
+    {
+      std::vector<unsigned char> finalKey(kCeBaseKey.begin(), kCeBaseKey.end());
+      if (ekid == "1")
+      {
+        const std::string packageHash = HashCanonicalLockList(canonicalLockList);
+        finalKey.insert(finalKey.end(), packageHash.begin(), packageHash.end());
+      }
+
+      if (scramble)
+      {
+        std::reverse(finalKey.begin(), finalKey.end());
+        for (auto& byte : finalKey)
+        {
+          byte ^= 0x7BU;
+        }
+      }
+
+      return finalKey;
+    }
+  }// namespace
+
+  std::string CanonicalPackageLockList(std::string_view packageLockList)
+  {
+    std::vector<std::string_view> items;
+    while (!packageLockList.empty())
+    {
+      const std::size_t separator = packageLockList.find(';');
+      const std::string_view item = packageLockList.substr(0, separator);
+      if (!item.empty())
+      {
+        items.push_back(item);
+      }
+      packageLockList.remove_prefix(separator == std::string_view::npos ? packageLockList.size() : separator + 1);
+    }
+
+    std::sort(items.begin(), items.end());
+    items.erase(std::unique(items.begin(), items.end()), items.end());
+
+    std::string canonical;
+    for (const auto item : items)
+    {
+      canonical.append(item);
+      canonical.push_back(';');
+    }
+    return canonical;
+  }
+
+  std::string ComputePackageLockHash(const PropertyMap& props)
+  {
+    return HashCanonicalLockList(CanonicalPackageLockList(GetPackageLockList(props)));
+  }
+
+  std::vector<unsigned char> BuildCeKey(const PropertyMap& props, const bool scramble)
+  {
+    return BuildCeKey(GetEkid(props), CanonicalPackageLockList(GetPackageLockList(props)), scramble);
+  }
+
+  CeKeyCache& CeKeyCache::Shared()
+  {
+    static CeKeyCache cache;
+    return cache;
+  }
+
+  std::shared_ptr<const BF_KEY> CeKeyCache::Get(const PropertyMap& props, const bool scramble)
+  {
+    const std::string_view ekid = GetEkid(props);
+    // The lock list only feeds the key for EKID 1
+    const std::string canonicalLockList = ekid == "1" ? CanonicalPackageLockList(GetPackageLockList(props)) : std::string();
+
+    std::string cacheKey;
+    cacheKey.reserve(ekid.size() + canonicalLockList.size() + 3);
+    cacheKey.append(ekid);
+    cacheKey.push_back('\0');
+    cacheKey.append(canonicalLockList);
+    cacheKey.push_back('\0');
+    cacheKey.push_back(scramble ? '1' : '0');
+
+    {
+      std::shared_lock lock(m_Mutex);
+      if (const auto it = m_Schedules.find(cacheKey); it != m_Schedules.end())
+      {
+        m_Hits.fetch_add(1, std::memory_order_relaxed);
+        return it->second;
+      }
+    }
+
+    m_Misses.fetch_add(1, std::memory_order_relaxed);
+    const auto finalKey = BuildCeKey(ekid, canonicalLockList, scramble);
+    auto schedule = std::make_shared<BF_KEY>();
+    BF_set_key(schedule.get(), static_cast<int>(finalKey.size()), finalKey.data());
+
+    std::unique_lock lock(m_Mutex);
+    if (m_Schedules.size() >= kMaxEntries)
+    {
+      m_Schedules.clear();
+    }
+    // Another thread may have inserted the same schedule meanwhile; either copy is fine
+    return m_Schedules.try_emplace(std::move(cacheKey), std::move(schedule)).first->second;
+  }
+
+  CeKeyCache::Stats CeKeyCache::GetStats() const
+  {
+    return {m_Hits.load(std::memory_order_relaxed), m_Misses.load(std::memory_order_relaxed)};
+  }
+
+  void CeKeyCache::Clear()
+  {
+    std::unique_lock lock(m_Mutex);
+    m_Schedules.clear();
+    m_Hits.store(0, std::memory_order_relaxed);
+    m_Misses.store(0, std::memory_order_relaxed);
+  }
+}// namespace Open3SDCM::detail
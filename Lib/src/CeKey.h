@@ -0,0 +1,58 @@
+//
+// CE schema Blowfish key derivation and the process-wide key schedule cache.
+//
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <openssl/blowfish.h>
+
+#include "DcmDocument.h"
+
+namespace Open3SDCM::detail
+{
+  // Sorted, de-duplicated PackageLockList items, each followed by ';'
+  std::string CanonicalPackageLockList(std::string_view packageLockList);
+
+  // Uppercase hex MD5 of the canonical PackageLockList, empty when there is none
+  std::string ComputePackageLockHash(const PropertyMap& props);
+
+  std::vector<unsigned char> BuildCeKey(const PropertyMap& props, bool scramble);
+
+  // BF_set_key fills ~4 KB of S-boxes per call, and every encrypted payload of
+  // every file needs a schedule. Schedules are cached per (EKID, canonical lock
+  // list, scramble flag); entries are immutable and shared between threads.
+  class CeKeyCache
+  {
+  public:
+    struct Stats
+    {
+      std::uint64_t hits{0};
+      std::uint64_t misses{0};
+    };
+
+    // Entry count above which the cache is emptied before inserting
+    static constexpr std::size_t kMaxEntries = 1024;
+
+    static CeKeyCache& Shared();
+
+    std::shared_ptr<const BF_KEY> Get(const PropertyMap& props, bool scramble);
+
+    [[nodiscard]] Stats GetStats() const;
+    void Clear();
+
+  private:
+    mutable std::shared_mutex m_Mutex;
+    std::unordered_map<std::string, std::shared_ptr<const BF_KEY>> m_Schedules;
+    std::atomic<std::uint64_t> m_Hits{0};
+    std::atomic<std::uint64_t> m_Misses{0};
+  };
+}// namespace Open3SDCM::detail
@@ -0,0 +1,46 @@
+//
+// The decoding stages of ParseDCM, one payload at a time (defined in ParseDcm.cpp).
+// DCMParser is the supported entry point; these are exposed for the benchmarks.
+//
+
+#pragma once
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "DcmDocument.h"
+#include "definitions.h"
+
+namespace Open3SDCM::detail
+{
+  // Base64 text of a payload (blankspace allowed) to bytes
+  std::vector<char> DecodeBuffer(std::string_view base64Text);
+
+  // Blowfish-decrypts a CE payload in place (other schemas pass through), then
+  // truncates it to `truncateSize` bytes if non-zero. `scrambleKey` selects the key
+  // variant of keyed texture coordinate streams.
+  std::vector<char> DecryptBuffer(std::vector<char> data,
+                                  std::string_view schema,
+                                  const PropertyMap& props,
+                                  bool scrambleKey = false,
+                                  std::size_t truncateSize = 0);
+
+  // Decoded facet payload to triangles; `info` records the payload width it settled on
+  std::vector<Triangle> InterpretFacetsBuffer(const std::vector<char>& rawData,
+                                              std::size_t expectedFaceCount,
+                                              FacetDecodeInfo& info);
+
+  // Reads the attributes of a <PerVertexTextureCoord> into `textureCoordinate` and
+  // returns its decoded, decrypted UV stream
+  std::vector<char> ReadTextureCoordinateStream(const DcmElement& textureCoordElement,
+                                                std::string_view schema,
+                                                const PropertyMap& properties,
+                                                TextureCoordinateData& textureCoordinate);
+
+  // UV stream to one optional coordinate per triangle corner
+  std::vector<std::optional<TextureCoordinate>> DecodePerVertexTextureCoordinates(const std::vector<char>& decryptedBytes,
+                                                                                  std::size_t vertexCount,
+                                                                                  const std::vector<Triangle>& triangles);
+}// namespace Open3SDCM::detail
@@ -0,0 +1,237 @@
+//
+// Single-pass extraction of the HPS elements the DCM decoder needs.
+//
+
+#include "DcmDocument.h"
+#include "XmlPullParser.h"
+
+namespace Open3SDCM::detail
+{
+  void DcmElement::AppendText(std::string_view rawText, const bool needsDecoding)
+  {
+    if (rawText.empty())
+    {
+      return;
+    }
+
+    if (!m_OwnsText && !needsDecoding && m_Text.empty())
+    {
+      m_Text = rawText;
+      return;
+    }
+
+    if (!m_OwnsText)
+    {
+      m_OwnedText.assign(m_Text);
+      m_OwnsText = true;
+    }
+
+    if (needsDecoding)
+    {
+      XmlPullParser::AppendCharacterData(rawText, false, m_OwnedText);
+    }
+    else
+    {
+      m_OwnedText.append(rawText);
+    }
+  }
+
+  namespace
+  {
+    // Tracks the first occurrence of an element while it is open
+    struct ElementScope
+    {
+      std::size_t depth{0};
+      bool done{false};
+
+      [[nodiscard]] bool IsOpen() const { return depth != 0; }
+
+      bool TryOpen(const std::size_t elementDepth)
+      {
+        if (done || IsOpen())
+        {
+          return false;
+        }
+        depth = elementDepth;
+        return true;
+      }
+
+      void CloseIfAt(const std::size_t elementDepth)
+      {
+        if (depth == elementDepth)
+        {
+          depth = 0;
+          done = true;
+        }
+      }
+    };
+
+    void CopyAttributes(const XmlPullParser& parser, DcmElement& element)
+    {
+      const auto allocator = element.attributes.get_allocator();
+      for (const auto& attribute : parser.Attributes())
+      {
+        std::pmr::string value(allocator);
+        XmlPullParser::AppendCharacterData(attribute.rawValue, true, value);
+        element.attributes.insert_or_assign(std::pmr::string(attribute.name, allocator), std::move(value));
+      }
+    }
+  }// namespace
+
+  DcmDocument ScanDcmDocument(std::string_view content, std::pmr::memory_resource* resource)
+  {
+    DcmDocument document(resource);
+    XmlPullParser parser(content, resource);
+
+    // The HPS layout this scan mirrors:
+    //   <HPS>
+    //     ... <Schema>CE</Schema> ... <Property name=".." value=".."/> (anywhere)
+    //     ... <Binary_data> ... <Vertices/> ... <Facets/> ... </Binary_data>
+    //     <TextureData2>
+    //       <PerVertexTextureCoord/>*
+    //       <TextureImages> <TextureImage/>* </TextureImages>
+    //     </TextureData2>
+    //     <TextureImages> <TextureImage/>* </TextureImages>   (used when there is no TextureData2)
+    //   </HPS>
+    ElementScope schemaScope;
+    bool collectSchemaText = false;
+    ElementScope binaryDataScope;
+    ElementScope textureDataScope;
+    ElementScope textureDataImagesScope;
+    ElementScope rootImagesScope;
+    std::pmr::vector<DcmElement> rootTextureImages(resource);
+
+    DcmElement* capture = nullptr;
+    std::size_t captureDepth = 0;
+    const auto beginCapture = [&](DcmElement& element, const std::size_t depth)
+    {
+      CopyAttributes(parser, element);
+      capture = &element;
+      captureDepth = depth;
+    };
+
+    for (auto event = parser.Next(); event != XmlPullParser::Event::EndDocument; event = parser.Next())
+    {
+      switch (event)
+      {
+        case XmlPullParser::Event::StartElement: {
+          // Like the DOM nodeValue of <Schema>'s first child, only the leading text counts
+          collectSchemaText = false;
+
+          const std::string_view name = parser.Name();
+          const std::size_t depth = parser.Depth();
+
+          if (name == "Property")
+          {
+            std::pmr::string propertyName(resource);
+            XmlPullParser::AppendCharacterData(parser.GetRawAttribute("name").value_or(""), true, propertyName);
+            if (!propertyName.empty())
+            {
+              std::pmr::string& value = document.properties[std::move(propertyName)];
+              value.clear();
+              XmlPullParser::AppendCharacterData(parser.GetRawAttribute("value").value_or(""), true, value);
+            }
+          }
+          else if (name == "Schema")
+          {
+            collectSchemaText = schemaScope.TryOpen(depth);
+          }
+
+          if (capture != nullptr)
+          {
+            break;
+          }
+
+          if (name == "Binary_data" && binaryDataScope.TryOpen(depth))
+          {
+            document.hasBinaryData = true;
+          }
+          else if (binaryDataScope.IsOpen() && name == "Vertices" && !document.vertices.has_value())
+          {
+            beginCapture(document.vertices.emplace(resource), depth);
+          }
+          else if (binaryDataScope.IsOpen() && name == "Facets" && !document.facets.has_value())
+          {
+            beginCapture(document.facets.emplace(resource), depth);
+          }
+          else if (depth == 2 && name == "TextureData2" && textureDataScope.TryOpen(depth))
+          {
+            document.hasTextureData = true;
+          }
+          else if (depth == 2 && name == "TextureImages")
+          {
+            rootImagesScope.TryOpen(depth);
+          }
+          else if (textureDataScope.IsOpen() && depth == textureDataScope.depth + 1)
+          {
+            if (name == "PerVertexTextureCoord")
+            {
+              beginCapture(document.textureCoordinates.emplace_back(), depth);
+            }
+            else if (name == "TextureImages")
+            {
+              textureDataImagesScope.TryOpen(depth);
+            }
+          }
+          else if (name == "TextureImage")
+          {
+            if (textureDataImagesScope.IsOpen() && depth == textureDataImagesScope.depth + 1)
+            {
+              beginCapture(document.textureImages.emplace_back(), depth);
+            }
+            else if (rootImagesScope.IsOpen() && depth == rootImagesScope.depth + 1)
+            {
+              beginCapture(rootTextureImages.emplace_back(), depth);
+            }
+          }
+          break;
+        }
+
+        case XmlPullParser::Event::Text: {
+          if (capture != nullptr)
+          {
+            capture->AppendText(parser.RawText(), parser.TextNeedsDecoding());
+          }
+          if (collectSchemaText)
+          {
+            if (parser.TextNeedsDecoding())
+            {
+              XmlPullParser::AppendCharacterData(parser.RawText(), false, document.schema);
+            }
+            else
+            {
+              document.schema.append(parser.RawText());
+            }
+          }
+          break;
+        }
+
+        case XmlPullParser::Event::EndElement: {
+          collectSchemaText = false;
+
+          const std::size_t depth = parser.Depth();
+          if (capture != nullptr && depth == captureDepth)
+          {
+            capture = nullptr;
+          }
+          schemaScope.CloseIfAt(depth);
+          binaryDataScope.CloseIfAt(depth);
+          textureDataScope.CloseIfAt(depth);
+          textureDataImagesScope.CloseIfAt(depth);
+          rootImagesScope.CloseIfAt(depth);
+          break;
+        }
+
+        case XmlPullParser::Event::EndDocument:
+          break;
+      }
+    }
+
+    if (!document.hasTextureData)
+    {
+      document.textureImages = std::move(rootTextureImages);
+    }
+
+    return document;
+  }
+}// namespace Open3SDCM::detail
@@ -0,0 +1,96 @@
+//
+// Single-pass extraction of the HPS elements the DCM decoder needs.
+//
+
+#pragma once
+#include <map>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Open3SDCM::detail
+{
+  // <Property> name -> value of an HPS document
+  using PropertyMap = std::pmr::map<std::pmr::string, std::pmr::string, std::less<>>;
+
+  // An HPS element captured during the scan: its attributes and its inner text
+  // (the concatenated character data of the element and all its descendants).
+  // Allocator-aware: inside a pmr container it allocates from the container's resource.
+  struct DcmElement
+  {
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    DcmElement() = default;
+    explicit DcmElement(const allocator_type& allocator) : attributes(allocator), m_OwnedText(allocator) {}
+    DcmElement(const DcmElement& other, const allocator_type& allocator)
+      : attributes(other.attributes, allocator), m_Text(other.m_Text), m_OwnedText(other.m_OwnedText, allocator), m_OwnsText(other.m_OwnsText)
+    {
+    }
+    DcmElement(DcmElement&& other, const allocator_type& allocator)
+      : attributes(std::move(other.attributes), allocator), m_Text(other.m_Text), m_OwnedText(std::move(other.m_OwnedText), allocator), m_OwnsText(other.m_OwnsText)
+    {
+    }
+    DcmElement(const DcmElement&) = default;
+    DcmElement(DcmElement&&) noexcept = default;
+    DcmElement& operator=(const DcmElement&) = default;
+    DcmElement& operator=(DcmElement&&) = default;
+
+    std::pmr::map<std::pmr::string, std::pmr::string, std::less<>> attributes;
+
+    [[nodiscard]] bool HasAttribute(std::string_view name) const
+    {
+      return attributes.find(name) != attributes.end();
+    }
+
+    // Returns the attribute value, or an empty view when it is absent. The view
+    // lives as long as the element.
+    [[nodiscard]] std::string_view GetAttribute(std::string_view name) const
+    {
+      const auto it = attributes.find(name);
+      return it == attributes.end() ? std::string_view() : std::string_view(it->second);
+    }
+
+    [[nodiscard]] std::string_view InnerText() const
+    {
+      return m_OwnsText ? std::string_view(m_OwnedText) : m_Text;
+    }
+
+    // Appends one run of character data. Runs that need no decoding are kept as views
+    // into the scanned document as long as the inner text is a single contiguous run.
+    void AppendText(std::string_view rawText, bool needsDecoding);
+
+  private:
+    std::string_view m_Text;
+    std::pmr::string m_OwnedText;
+    bool m_OwnsText{false};
+  };
+
+  // Everything ParseDCM consumes from an HPS document. Element texts may reference
+  // the scanned buffer, which must therefore outlive the document. Every string and
+  // container of the document allocates from `resource`.
+  struct DcmDocument
+  {
+    explicit DcmDocument(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : schema(resource), properties(resource), textureCoordinates(resource), textureImages(resource)
+    {
+    }
+
+    std::pmr::string schema;
+    PropertyMap properties;
+
+    bool hasBinaryData{false};
+    std::optional<DcmElement> vertices;// first <Vertices> below the first <Binary_data>
+    std::optional<DcmElement> facets;  // first <Facets> below the first <Binary_data>
+
+    bool hasTextureData{false};                   // root has a <TextureData2> child
+    std::pmr::vector<DcmElement> textureCoordinates;// <PerVertexTextureCoord> children of <TextureData2>
+    std::pmr::vector<DcmElement> textureImages;     // <TextureImage> children of the selected <TextureImages>
+  };
+
+  // Scans the whole document once, front to back, without building a DOM.
+  // The document and its elements allocate from `resource` (e.g. the per-parse
+  // arena of a DCMParser). Throws Poco::XML::XMLException on malformed input.
+  DcmDocument ScanDcmDocument(std::string_view content, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+}// namespace Open3SDCM::detail
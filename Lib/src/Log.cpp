@@ -0,0 +1,104 @@
+//
+// Library logging through a replaceable spdlog logger; silent unless the application installs one.
+//
+
+#include "Log.h"
+
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <spdlog/async.h>
+#include <spdlog/sinks/null_sink.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+namespace Open3SDCM
+{
+  namespace
+  {
+    constexpr std::size_t kAsyncQueueSize = 8192;
+
+    std::shared_ptr<spdlog::logger> MakeSilentLogger()
+    {
+      auto logger = std::make_shared<spdlog::logger>("open3sdcm", std::make_shared<spdlog::sinks::null_sink_mt>());
+      logger->set_level(spdlog::level::off);
+      return logger;
+    }
+
+    struct LoggerState
+    {
+      std::mutex mutex;
+      std::shared_ptr<spdlog::logger> current = MakeSilentLogger();
+      // Every logger ever installed: a thread may still hold a reference from ActiveLogger()
+      std::vector<std::shared_ptr<spdlog::logger>> retired;
+      std::shared_ptr<spdlog::details::thread_pool> asyncPool;
+      std::atomic<spdlog::logger*> active{current.get()};
+    };
+
+    LoggerState& State()
+    {
+      static LoggerState state;
+      return state;
+    }
+  }// namespace
+
+  void SetLogger(std::shared_ptr<spdlog::logger> logger)
+  {
+    LoggerState& state = State();
+    std::lock_guard lock(state.mutex);
+    state.retired.push_back(std::move(state.current));
+    state.current = logger ? std::move(logger) : MakeSilentLogger();
+    state.active.store(state.current.get(), std::memory_order_release);
+  }
+
+  std::shared_ptr<spdlog::logger> GetLogger()
+  {
+    LoggerState& state = State();
+    std::lock_guard lock(state.mutex);
+    return state.current;
+  }
+
+  std::shared_ptr<spdlog::logger> MakeAsyncStderrLogger(const spdlog::level::level_enum level)
+  {
+    LoggerState& state = State();
+    std::shared_ptr<spdlog::details::thread_pool> pool;
+    {
+      std::lock_guard lock(state.mutex);
+      if (!state.asyncPool)
+      {
+        state.asyncPool = std::make_shared<spdlog::details::thread_pool>(kAsyncQueueSize, 1);
+      }
+      pool = state.asyncPool;
+    }
+
+    auto logger = std::make_shared<spdlog::async_logger>("open3sdcm",
+                                                         std::make_shared<spdlog::sinks::stderr_color_sink_mt>(),
+                                                         pool,
+                                                         spdlog::async_overflow_policy::block);
+    logger->set_level(level);
+    logger->set_pattern("[%H:%M:%S.%e] [%^%l%$] %v");
+    return logger;
+  }
+
+  void ShutdownLogging()
+  {
+    SetLogger(nullptr);
+    std::shared_ptr<spdlog::details::thread_pool> pool;
+    {
+      LoggerState& state = State();
+      std::lock_guard lock(state.mutex);
+      pool = std::move(state.asyncPool);
+    }
+    // The async loggers only hold the pool weakly: releasing it drains the queue and joins the thread
+    pool.reset();
+  }
+
+  namespace detail
+  {
+    spdlog::logger& ActiveLogger()
+    {
+      return *State().active.load(std::memory_order_acquire);
+    }
+  }// namespace detail
+}// namespace Open3SDCM
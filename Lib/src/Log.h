@@ -0,0 +1,80 @@
+//
+// Library logging through a replaceable spdlog logger; silent unless the application installs one.
+//
+
+#pragma once
+#include <memory>
+
+#include <spdlog/spdlog.h>
+
+namespace Open3SDCM
+{
+  // Receives every message of the library and of the CLI. The default logger
+  // discards everything at level off, so that a log call costs one atomic load.
+  // Passing null restores it. Set it before parsing: loggers replaced while a
+  // parse runs are kept alive until exit.
+  void SetLogger(std::shared_ptr<spdlog::logger> logger);
+  std::shared_ptr<spdlog::logger> GetLogger();
+
+  // Writes to stderr from one background thread, so that the parse threads
+  // never wait on the console. A full queue (8192 messages) blocks the caller
+  // rather than dropping messages.
+  std::shared_ptr<spdlog::logger> MakeAsyncStderrLogger(spdlog::level::level_enum level);
+
+  // Restores the silent logger and waits until the queued messages of
+  // MakeAsyncStderrLogger's loggers are written. Call once no parse is running.
+  void ShutdownLogging();
+
+  namespace detail
+  {
+    spdlog::logger& ActiveLogger();
+  }
+}// namespace Open3SDCM
+
+// Arguments are only evaluated when the level is enabled. Levels below
+// SPDLOG_ACTIVE_LEVEL (CMake: Open3SDCM_LOG_LEVEL) are compiled out.
+#define O3SDCM_LOG(level, ...)                                                                 \
+  do                                                                                           \
+  {                                                                                            \
+    spdlog::logger& o3sdcmLogger = ::Open3SDCM::detail::ActiveLogger();                        \
+    if (o3sdcmLogger.should_log(level))                                                        \
+    {                                                                                          \
+      o3sdcmLogger.log(spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION}, level, __VA_ARGS__); \
+    }                                                                                          \
+  } while (false)
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+#define O3SDCM_LOG_TRACE(...) O3SDCM_LOG(spdlog::level::trace, __VA_ARGS__)
+#else
+#define O3SDCM_LOG_TRACE(...) (void)0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define O3SDCM_LOG_DEBUG(...) O3SDCM_LOG(spdlog::level::debug, __VA_ARGS__)
+#else
+#define O3SDCM_LOG_DEBUG(...) (void)0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+#define O3SDCM_LOG_INFO(...) O3SDCM_LOG(spdlog::level::info, __VA_ARGS__)
+#else
+#define O3SDCM_LOG_INFO(...) (void)0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+#define O3SDCM_LOG_WARN(...) O3SDCM_LOG(spdlog::level::warn, __VA_ARGS__)
+#else
+#define O3SDCM_LOG_WARN(...) (void)0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
+#define O3SDCM_LOG_ERROR(...) O3SDCM_LOG(spdlog::level::err, __VA_ARGS__)
+#else
+#define O3SDCM_LOG_ERROR(...) (void)0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_CRITICAL
+#define O3SDCM_LOG_CRITICAL(...) O3SDCM_LOG(spdlog::level::critical, __VA_ARGS__)
+#else
+#define O3SDCM_LOG_CRITICAL(...) (void)0
+#endif
@@ -0,0 +1,196 @@
+//
+// Read-only view of a whole input file, memory-mapped when the platform allows it.
+//
+
+#include "MappedFile.h"
+
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+#include <Poco/Exception.h>
+#include <fmt/format.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Open3SDCM::detail
+{
+  MappedFile::MappedFile(const std::filesystem::path& filePath)
+  {
+    std::error_code errorCode;
+    if (!std::filesystem::is_regular_file(filePath, errorCode))
+    {
+      throw Poco::FileNotFoundException(fmt::format("File not found: {}", filePath.string()));
+    }
+
+    if (!TryMap(filePath))
+    {
+      ReadIntoBuffer(filePath);
+    }
+  }
+
+  MappedFile::~MappedFile()
+  {
+    Release();
+  }
+
+  MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_Data(std::exchange(other.m_Data, nullptr)),
+      m_Size(std::exchange(other.m_Size, 0)),
+      m_Mapping(std::exchange(other.m_Mapping, nullptr)),
+      m_Buffer(std::move(other.m_Buffer))
+  {
+  }
+
+  MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+  {
+    if (this != &other)
+    {
+      Release();
+      m_Data = std::exchange(other.m_Data, nullptr);
+      m_Size = std::exchange(other.m_Size, 0);
+      m_Mapping = std::exchange(other.m_Mapping, nullptr);
+      m_Buffer = std::move(other.m_Buffer);
+    }
+    return *this;
+  }
+
+  void MappedFile::Prefetch() const
+  {
+    if (m_Mapping == nullptr)
+    {
+      return;
+    }
+
+#if !defined(_WIN32)
+    // Let the kernel start read-ahead on the whole range before we fault it page by page
+    ::madvise(m_Mapping, m_Size, MADV_WILLNEED);
+#endif
+
+    // One load per page; 4 KiB is the smallest page size we run on
+    constexpr std::size_t kPageStride = 4096;
+    unsigned char checksum = 0;
+    for (std::size_t offset = 0; offset < m_Size; offset += kPageStride)
+    {
+      checksum ^= static_cast<unsigned char>(m_Data[offset]);
+    }
+    // Keeps the loads from being optimized away
+    volatile unsigned char sink = checksum;
+    static_cast<void>(sink);
+  }
+
+  void MappedFile::Release() noexcept
+  {
+    if (m_Mapping != nullptr)
+    {
+#if defined(_WIN32)
+      UnmapViewOfFile(m_Mapping);
+#else
+      munmap(m_Mapping, m_Size);
+#endif
+      m_Mapping = nullptr;
+    }
+    m_Buffer.reset();
+    m_Data = nullptr;
+    m_Size = 0;
+  }
+
+  bool MappedFile::TryMap(const std::filesystem::path& filePath)
+  {
+#if defined(_WIN32)
+    HANDLE file = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+      return false;
+    }
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+      CloseHandle(file);
+      return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr)
+    {
+      return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);// the view keeps the mapping alive
+    if (view == nullptr)
+    {
+      return false;
+    }
+
+    m_Mapping = view;
+    m_Data = static_cast<const char*>(view);
+    m_Size = static_cast<std::size_t>(fileSize.QuadPart);
+    return true;
+#else
+    const int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+      return false;
+    }
+
+    struct stat fileStatus{};
+    if (::fstat(fd, &fileStatus) != 0 || fileStatus.st_size <= 0)
+    {
+      ::close(fd);
+      return false;
+    }
+
+    const auto size = static_cast<std::size_t>(fileStatus.st_size);
+    void* view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);// the mapping keeps its own reference to the file
+    if (view == MAP_FAILED)
+    {
+      return false;
+    }
+
+    // The scan and the decoders walk the file front to back
+    ::madvise(view, size, MADV_SEQUENTIAL);
+
+    m_Mapping = view;
+    m_Data = static_cast<const char*>(view);
+    m_Size = size;
+    return true;
+#endif
+  }
+
+  void MappedFile::ReadIntoBuffer(const std::filesystem::path& filePath)
+  {
+    std::ifstream input(filePath, std::ios::binary);
+    if (!input)
+    {
+      throw Poco::OpenFileException(fmt::format("Cannot open file: {}", filePath.string()));
+    }
+
+    std::error_code errorCode;
+    const auto size = static_cast<std::size_t>(std::filesystem::file_size(filePath, errorCode));
+    if (errorCode)
+    {
+      throw Poco::ReadFileException(fmt::format("Cannot get size of file: {}", filePath.string()));
+    }
+
+    m_Buffer.reset(new char[size]);
+    if (size > 0 && !input.read(m_Buffer.get(), static_cast<std::streamsize>(size)))
+    {
+      throw Poco::ReadFileException(fmt::format("Cannot read file: {}", filePath.string()));
+    }
+
+    m_Data = m_Buffer.get();
+    m_Size = size;
+  }
+}// namespace Open3SDCM::detail
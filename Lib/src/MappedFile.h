@@ -0,0 +1,49 @@
+//
+// Read-only view of a whole input file, memory-mapped when the platform allows it.
+//
+
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+
+namespace Open3SDCM::detail
+{
+  // Exposes the content of a file as one contiguous read-only buffer.
+  // The file is memory-mapped when possible; otherwise (mapping unsupported or
+  // refused, e.g. on some network filesystems) it is read once into a single
+  // heap buffer. Either way no further copy of the content is made.
+  class MappedFile
+  {
+  public:
+    // Throws Poco::FileNotFoundException / Poco::OpenFileException / Poco::ReadFileException
+    explicit MappedFile(const std::filesystem::path& filePath);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    [[nodiscard]] std::string_view View() const { return {m_Data, m_Size}; }
+    [[nodiscard]] std::span<const std::byte> Bytes() const { return {reinterpret_cast<const std::byte*>(m_Data), m_Size}; }
+    [[nodiscard]] std::size_t Size() const { return m_Size; }
+    [[nodiscard]] bool IsMapped() const { return m_Mapping != nullptr; }
+
+    // Faults every page of a mapped file in now, so that later reads do not wait
+    // on storage. No-op for a file read into memory.
+    void Prefetch() const;
+
+  private:
+    void Release() noexcept;
+    bool TryMap(const std::filesystem::path& filePath);
+    void ReadIntoBuffer(const std::filesystem::path& filePath);
+
+    const char* m_Data{nullptr};
+    std::size_t m_Size{0};
+    void* m_Mapping{nullptr};          // base address of the mapping, if mapped
+    std::unique_ptr<char[]> m_Buffer;  // fallback storage, if read
+  };
+}// namespace Open3SDCM::detail
@@ -0,0 +1,578 @@
+//
+// Binary cache of decoded meshes: decode a DCM once, load it back in a few milliseconds.
+//
+
+#include "MeshCache.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <span>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include <openssl/evp.h>
+
+#include <Poco/Exception.h>
+#include <fmt/format.h>
+
+namespace fs = std::filesystem;
+
+namespace Open3SDCM::detail
+{
+  namespace
+  {
+    constexpr std::array<char, 8> kMagic = {'O', '3', 'S', 'D', 'C', 'M', 'C', '\0'};
+    constexpr std::size_t kHeaderSize = 64;
+    constexpr std::size_t kBlockEntrySize = 24;
+    constexpr std::size_t kBlockAlignment = 64;
+
+    enum class BlockKind : std::uint32_t
+    {
+      Vertices = 1,
+      Triangles = 2,
+      Metadata = 3,
+      TextureCoordinates = 4,       // item: index of the texture coordinate set
+      TextureCoordinatePresence = 5,// item: index of the texture coordinate set
+      TextureImage = 6              // item: index of the texture image
+    };
+
+    struct BlockEntry
+    {
+      BlockKind kind{};
+      std::uint32_t item{0};
+      std::uint64_t offset{0};
+      std::uint64_t size{0};
+    };
+
+    constexpr std::uint64_t AlignBlock(const std::uint64_t offset)
+    {
+      return (offset + kBlockAlignment - 1) & ~std::uint64_t{kBlockAlignment - 1};
+    }
+
+    // The format is little-endian and only written and read on little-endian hosts,
+    // where its integers are the native representation
+    template<typename T>
+    void Store(std::uint8_t* bytes, const T value)
+    {
+      std::memcpy(bytes, &value, sizeof(T));
+    }
+
+    template<typename T>
+    T Load(const std::uint8_t* bytes)
+    {
+      T value;
+      std::memcpy(&value, bytes, sizeof(T));
+      return value;
+    }
+
+    template<typename T>
+    std::span<const std::uint8_t> AsBytes(const std::vector<T>& values)
+    {
+      return {reinterpret_cast<const std::uint8_t*>(values.data()), values.size() * sizeof(T)};
+    }
+
+    // Sequential encoding of the small fields; strings are a u32 length and their
+    // bytes, an absent optional string has length 0xFFFFFFFF
+    class MetadataWriter
+    {
+    public:
+      template<typename T>
+      void Put(const T value)
+      {
+        const std::size_t offset = m_Bytes.size();
+        m_Bytes.resize(offset + sizeof(T));
+        Store(m_Bytes.data() + offset, value);
+      }
+
+      void PutString(const std::optional<std::string>& text)
+      {
+        if (!text.has_value())
+        {
+          Put(std::numeric_limits<std::uint32_t>::max());
+          return;
+        }
+        Put(static_cast<std::uint32_t>(text->size()));
+        m_Bytes.insert(m_Bytes.end(), text->begin(), text->end());
+      }
+
+      [[nodiscard]] const std::vector<std::uint8_t>& Bytes() const { return m_Bytes; }
+
+    private:
+      std::vector<std::uint8_t> m_Bytes;
+    };
+
+    class MetadataReader
+    {
+    public:
+      explicit MetadataReader(const std::span<const std::uint8_t> bytes)
+        : m_Bytes(bytes)
+      {
+      }
+
+      template<typename T>
+      T Get()
+      {
+        return Load<T>(Take(sizeof(T)).data());
+      }
+
+      std::optional<std::string> GetString()
+      {
+        const auto size = Get<std::uint32_t>();
+        if (size == std::numeric_limits<std::uint32_t>::max())
+        {
+          return std::nullopt;
+        }
+        const auto text = Take(size);
+        return std::string(reinterpret_cast<const char*>(text.data()), text.size());
+      }
+
+    private:
+      std::span<const std::uint8_t> Take(const std::size_t size)
+      {
+        if (size > m_Bytes.size() - m_Offset)
+        {
+          throw Poco::DataFormatException("Truncated mesh cache metadata");
+        }
+        const auto bytes = m_Bytes.subspan(m_Offset, size);
+        m_Offset += size;
+        return bytes;
+      }
+
+      std::span<const std::uint8_t> m_Bytes;
+      std::size_t m_Offset{0};
+    };
+
+    std::vector<std::uint8_t> EncodeMetadata(const SurfaceData& surfaceData, const FacetDecodeInfo& facetDecodeInfo)
+    {
+      MetadataWriter writer;
+      const ColorRGB baseColor = surfaceData.baseColor.value_or(ColorRGB{});
+      writer.Put(static_cast<std::uint8_t>(surfaceData.baseColor.has_value()));
+      writer.Put(baseColor.r);
+      writer.Put(baseColor.g);
+      writer.Put(baseColor.b);
+
+      writer.Put(static_cast<std::uint8_t>(facetDecodeInfo.width));
+      writer.Put(static_cast<std::uint8_t>(facetDecodeInfo.reason));
+      writer.Put(static_cast<std::uint64_t>(facetDecodeInfo.expectedFaceCount));
+      writer.Put(static_cast<std::uint64_t>(facetDecodeInfo.prescanFaceCount16));
+      writer.Put(static_cast<std::uint64_t>(facetDecodeInfo.prescanFaceCount32));
+      writer.Put(static_cast<std::uint64_t>(facetDecodeInfo.decodedFaceCount));
+      writer.Put(static_cast<std::uint64_t>(facetDecodeInfo.decodePasses));
+
+      writer.Put(static_cast<std::uint32_t>(surfaceData.textureCoordinates.size()));
+      for (const auto& coordinates : surfaceData.textureCoordinates)
+      {
+        writer.PutString(coordinates.textureCoordId);
+        writer.PutString(coordinates.textureId);
+        writer.PutString(coordinates.key);
+        writer.Put(static_cast<std::uint64_t>(coordinates.encodedByteCount));
+        writer.Put(static_cast<std::uint64_t>(coordinates.cornerCoordinates.size()));
+      }
+
+      writer.Put(static_cast<std::uint32_t>(surfaceData.textureImages.size()));
+      for (const auto& image : surfaceData.textureImages)
+      {
+        writer.PutString(image.id);
+        writer.PutString(image.textureId);
+        writer.PutString(image.refTextureCoordId);
+        writer.PutString(image.textureCoordSet);
+        writer.PutString(image.textureName);
+        writer.PutString(image.version);
+        writer.PutString(image.mimeType);
+        writer.Put(static_cast<std::uint64_t>(image.width));
+        writer.Put(static_cast<std::uint64_t>(image.height));
+        writer.Put(static_cast<std::uint64_t>(image.bytesPerPixel));
+        writer.Put(static_cast<std::uint64_t>(image.encodedByteCount));
+        writer.Put(static_cast<std::uint64_t>(image.imageBytes.size()));
+      }
+      return writer.Bytes();
+    }
+
+    // The sizes the metadata announces for the variable-length blocks
+    struct BlockSizes
+    {
+      std::vector<std::uint64_t> cornerCounts;
+      std::vector<std::uint64_t> imageByteCounts;
+    };
+
+    BlockSizes DecodeMetadata(const std::span<const std::uint8_t> bytes, DecodedMesh& mesh)
+    {
+      MetadataReader reader(bytes);
+      BlockSizes sizes;
+
+      const bool hasBaseColor = reader.Get<std::uint8_t>() != 0;
+      ColorRGB baseColor;
+      baseColor.r = reader.Get<std::uint8_t>();
+      baseColor.g = reader.Get<std::uint8_t>();
+      baseColor.b = reader.Get<std::uint8_t>();
+      if (hasBaseColor)
+      {
+        mesh.surfaceData.baseColor = baseColor;
+      }
+
+      auto& info = mesh.facetDecodeInfo;
+      info.width = static_cast<FacetIndexWidth>(reader.Get<std::uint8_t>());
+      info.reason = static_cast<FacetWidthReason>(reader.Get<std::uint8_t>());
+      info.expectedFaceCount = reader.Get<std::uint64_t>();
+      info.prescanFaceCount16 = reader.Get<std::uint64_t>();
+      info.prescanFaceCount32 = reader.Get<std::uint64_t>();
+      info.decodedFaceCount = reader.Get<std::uint64_t>();
+      info.decodePasses = reader.Get<std::uint64_t>();
+
+      const auto coordinateSetCount = reader.Get<std::uint32_t>();
+      for (std::uint32_t setIndex = 0; setIndex < coordinateSetCount; ++setIndex)
+      {
+        auto& coordinates = mesh.surfaceData.textureCoordinates.emplace_back();
+        coordinates.textureCoordId = reader.GetString();
+        coordinates.textureId = reader.GetString();
+        coordinates.key = reader.GetString();
+        coordinates.encodedByteCount = reader.Get<std::uint64_t>();
+        sizes.cornerCounts.push_back(reader.Get<std::uint64_t>());
+      }
+
+      const auto imageCount = reader.Get<std::uint32_t>();
+      for (std::uint32_t imageIndex = 0; imageIndex < imageCount; ++imageIndex)
+      {
+        auto& image = mesh.surfaceData.textureImages.emplace_back();
+        image.id = reader.GetString();
+        image.textureId = reader.GetString();
+        image.refTextureCoordId = reader.GetString();
+        image.textureCoordSet = reader.GetString();
+        image.textureName = reader.GetString();
+        image.version = reader.GetString();
+        image.mimeType = reader.GetString();
+        image.width = reader.Get<std::uint64_t>();
+        image.height = reader.Get<std::uint64_t>();
+        image.bytesPerPixel = reader.Get<std::uint64_t>();
+        image.encodedByteCount = reader.Get<std::uint64_t>();
+        sizes.imageByteCounts.push_back(reader.Get<std::uint64_t>());
+      }
+      return sizes;
+    }
+
+    // Locates the blocks of a mapped cache file, all checked to lie inside it
+    class BlockTable
+    {
+    public:
+      explicit BlockTable(const std::span<const std::uint8_t> file)
+        : m_File(file)
+      {
+        const auto blockCount = Load<std::uint32_t>(file.data() + 12);
+        if (blockCount > (file.size() - kHeaderSize) / kBlockEntrySize)
+        {
+          throw Poco::DataFormatException("Mesh cache block table exceeds the file");
+        }
+
+        const std::uint8_t* entry = file.data() + kHeaderSize;
+        for (std::uint32_t blockIndex = 0; blockIndex < blockCount; ++blockIndex, entry += kBlockEntrySize)
+        {
+          const BlockEntry block{static_cast<BlockKind>(Load<std::uint32_t>(entry)),
+                                 Load<std::uint32_t>(entry + 4),
+                                 Load<std::uint64_t>(entry + 8),
+                                 Load<std::uint64_t>(entry + 16)};
+          if (block.offset > file.size() || block.size > file.size() - block.offset)
+          {
+            throw Poco::DataFormatException("Mesh cache block exceeds the file");
+          }
+          m_Blocks.push_back(block);
+        }
+      }
+
+      [[nodiscard]] std::optional<std::span<const std::uint8_t>> Find(const BlockKind kind, const std::uint32_t item = 0) const
+      {
+        const auto it = std::find_if(m_Blocks.begin(), m_Blocks.end(), [kind, item](const BlockEntry& block) {
+          return block.kind == kind && block.item == item;
+        });
+        if (it == m_Blocks.end())
+        {
+          return std::nullopt;
+        }
+        return m_File.subspan(it->offset, it->size);
+      }
+
+      // A block that must be present with exactly `size` bytes
+      [[nodiscard]] std::span<const std::uint8_t> Require(const BlockKind kind, const std::uint32_t item, const std::uint64_t size) const
+      {
+        const auto block = Find(kind, item);
+        if (!block.has_value() || block->size() != size)
+        {
+          throw Poco::DataFormatException("Missing or mis-sized mesh cache block");
+        }
+        return *block;
+      }
+
+    private:
+      std::span<const std::uint8_t> m_File;
+      std::vector<BlockEntry> m_Blocks;
+    };
+
+    template<typename T>
+    void CopyBlock(const std::span<const std::uint8_t> block, std::vector<T>& values)
+    {
+      if (block.size() % sizeof(T) != 0)
+      {
+        throw Poco::DataFormatException("Mis-sized mesh cache block");
+      }
+      values.resize(block.size() / sizeof(T));
+      std::memcpy(values.data(), block.data(), block.size());
+    }
+
+    DecodedMesh ReadBlocks(const std::span<const std::uint8_t> file)
+    {
+      const BlockTable blocks(file);
+      DecodedMesh mesh;
+
+      const auto metadata = blocks.Find(BlockKind::Metadata);
+      if (!metadata.has_value())
+      {
+        throw Poco::DataFormatException("Mesh cache has no metadata block");
+      }
+      const BlockSizes sizes = DecodeMetadata(*metadata, mesh);
+
+      const auto vertices = blocks.Find(BlockKind::Vertices);
+      const auto triangles = blocks.Find(BlockKind::Triangles);
+      if (!vertices.has_value() || !triangles.has_value() || vertices->size() % (3 * sizeof(float)) != 0)
+      {
+        throw Poco::DataFormatException("Mesh cache has no valid geometry blocks");
+      }
+      CopyBlock(*vertices, mesh.vertices);
+      CopyBlock(*triangles, mesh.triangles);
+
+      // The exporters index m_Vertices without checks
+      const std::size_t vertexCount = mesh.vertices.size() / 3;
+      const auto indices = AsIndexBuffer(mesh.triangles);
+      if (std::any_of(indices.begin(), indices.end(), [vertexCount](const std::uint32_t index) { return index >= vertexCount; }))
+      {
+        throw Poco::DataFormatException("Mesh cache vertex index out of range");
+      }
+
+      for (std::uint32_t setIndex = 0; setIndex < sizes.cornerCounts.size(); ++setIndex)
+      {
+        const std::uint64_t cornerCount = sizes.cornerCounts[setIndex];
+        if (cornerCount > file.size())
+        {
+          throw Poco::DataFormatException("Mis-sized mesh cache block");
+        }
+        std::vector<float> values;
+        CopyBlock(blocks.Require(BlockKind::TextureCoordinates, setIndex, cornerCount * 2 * sizeof(float)), values);
+        const auto presence = blocks.Find(BlockKind::TextureCoordinatePresence, setIndex);
+        if (presence.has_value() && presence->size() != cornerCount)
+        {
+          throw Poco::DataFormatException("Mis-sized mesh cache block");
+        }
+
+        auto& cornerCoordinates = mesh.surfaceData.textureCoordinates[setIndex].cornerCoordinates;
+        cornerCoordinates.resize(cornerCount);
+        for (std::size_t cornerIndex = 0; cornerIndex < cornerCount; ++cornerIndex)
+        {
+          if (!presence.has_value() || (*presence)[cornerIndex] != 0)
+          {
+            cornerCoordinates[cornerIndex] = TextureCoordinate{values[cornerIndex * 2], values[cornerIndex * 2 + 1]};
+          }
+        }
+      }
+
+      for (std::uint32_t imageIndex = 0; imageIndex < sizes.imageByteCounts.size(); ++imageIndex)
+      {
+        CopyBlock(blocks.Require(BlockKind::TextureImage, imageIndex, sizes.imageByteCounts[imageIndex]),
+                  mesh.surfaceData.textureImages[imageIndex].imageBytes);
+      }
+      return mesh;
+    }
+  }// namespace
+
+  ContentHash HashContent(const std::string_view content)
+  {
+    ContentHash hash{};
+    unsigned int hashSize = 0;
+    if (EVP_Digest(content.data(), content.size(), hash.data(), &hashSize, EVP_sha256(), nullptr) != 1 ||
+        hashSize != hash.size())
+    {
+      throw Poco::RuntimeException("SHA-256 of the source content failed");
+    }
+    return hash;
+  }
+
+  fs::path MeshCachePath(const fs::path& cacheDirectory, const fs::path& sourcePath)
+  {
+    std::error_code errorCode;
+    fs::path absolutePath = fs::absolute(sourcePath, errorCode);
+    if (errorCode)
+    {
+      absolutePath = sourcePath;
+    }
+    const ContentHash pathHash = HashContent(absolutePath.lexically_normal().string());
+    std::uint64_t pathKey = 0;
+    std::memcpy(&pathKey, pathHash.data(), sizeof(pathKey));
+    return cacheDirectory / fmt::format("{}-{:016x}.o3mc", sourcePath.stem().string(), pathKey);
+  }
+
+  bool WriteMeshCache(const fs::path& cachePath,
+                      const ContentHash& sourceHash,
+                      const std::vector<float>& vertices,
+                      const std::vector<Triangle>& triangles,
+                      const SurfaceData& surfaceData,
+                      const FacetDecodeInfo& facetDecodeInfo)
+  {
+    if constexpr (std::endian::native != std::endian::little)
+    {
+      return false;
+    }
+
+    // Blocks that are not already laid out as the file wants them are packed here
+    const std::vector<std::uint8_t> metadata = EncodeMetadata(surfaceData, facetDecodeInfo);
+    std::vector<std::vector<float>> packedCoordinates;
+    std::vector<std::vector<std::uint8_t>> packedPresence;
+
+    struct PendingBlock
+    {
+      BlockKind kind;
+      std::uint32_t item;
+      std::span<const std::uint8_t> bytes;
+    };
+    std::vector<PendingBlock> pending;
+    pending.push_back({BlockKind::Metadata, 0, metadata});
+    pending.push_back({BlockKind::Vertices, 0, AsBytes(vertices)});
+    pending.push_back({BlockKind::Triangles, 0, AsBytes(triangles)});
+
+    packedCoordinates.reserve(surfaceData.textureCoordinates.size());
+    packedPresence.reserve(surfaceData.textureCoordinates.size());
+    for (std::uint32_t setIndex = 0; setIndex < surfaceData.textureCoordinates.size(); ++setIndex)
+    {
+      const auto& cornerCoordinates = surfaceData.textureCoordinates[setIndex].cornerCoordinates;
+      const bool allPresent = std::all_of(cornerCoordinates.begin(), cornerCoordinates.end(), [](const auto& coordinate) {
+        return coordinate.has_value();
+      });
+      auto& values = packedCoordinates.emplace_back(cornerCoordinates.size() * 2, 0.0F);
+      auto& presence = packedPresence.emplace_back(allPresent ? 0 : cornerCoordinates.size(), std::uint8_t{0});
+      for (std::size_t cornerIndex = 0; cornerIndex < cornerCoordinates.size(); ++cornerIndex)
+      {
+        if (cornerCoordinates[cornerIndex].has_value())
+        {
+          values[cornerIndex * 2] = cornerCoordinates[cornerIndex]->u;
+          values[cornerIndex * 2 + 1] = cornerCoordinates[cornerIndex]->v;
+          if (!allPresent)
+          {
+            presence[cornerIndex] = 1;
+          }
+        }
+      }
+      pending.push_back({BlockKind::TextureCoordinates, setIndex, AsBytes(values)});
+      if (!presence.empty())
+      {
+        pending.push_back({BlockKind::TextureCoordinatePresence, setIndex, AsBytes(presence)});
+      }
+    }
+
+    for (std::uint32_t imageIndex = 0; imageIndex < surfaceData.textureImages.size(); ++imageIndex)
+    {
+      pending.push_back({BlockKind::TextureImage, imageIndex, AsBytes(surfaceData.textureImages[imageIndex].imageBytes)});
+    }
+
+    // Header and block table
+    std::vector<std::uint8_t> head(kHeaderSize + pending.size() * kBlockEntrySize, 0);
+    std::uint64_t offset = AlignBlock(head.size());
+    for (std::size_t blockIndex = 0; blockIndex < pending.size(); ++blockIndex)
+    {
+      std::uint8_t* entry = head.data() + kHeaderSize + blockIndex * kBlockEntrySize;
+      Store(entry, static_cast<std::uint32_t>(pending[blockIndex].kind));
+      Store(entry + 4, pending[blockIndex].item);
+      Store(entry + 8, offset);
+      Store(entry + 16, static_cast<std::uint64_t>(pending[blockIndex].bytes.size()));
+      offset = AlignBlock(offset + pending[blockIndex].bytes.size());
+    }
+    const std::uint64_t fileSize = offset;
+
+    std::memcpy(head.data(), kMagic.data(), kMagic.size());
+    Store(head.data() + 8, kMeshCacheVersion);
+    Store(head.data() + 12, static_cast<std::uint32_t>(pending.size()));
+    std::memcpy(head.data() + 16, sourceHash.data(), sourceHash.size());
+    Store(head.data() + 48, fileSize);
+    Store(head.data() + 56, kDecoderRevision);
+
+    std::error_code errorCode;
+    fs::create_directories(cachePath.parent_path(), errorCode);
+
+    // Unique per thread and attempt, so that parallel writers never share a temporary
+    const auto ticks = std::chrono::steady_clock::now().time_since_epoch().count();
+    fs::path temporaryPath = cachePath;
+    temporaryPath += fmt::format(".{:x}-{:x}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()), ticks);
+
+    {
+      std::ofstream output(temporaryPath, std::ios::binary);
+      if (!output)
+      {
+        return false;
+      }
+
+      static constexpr std::array<char, kBlockAlignment> kPadding{};
+      std::uint64_t written = head.size();
+      output.write(reinterpret_cast<const char*>(head.data()), static_cast<std::streamsize>(head.size()));
+      for (const PendingBlock& block : pending)
+      {
+        output.write(kPadding.data(), static_cast<std::streamsize>(AlignBlock(written) - written));
+        output.write(reinterpret_cast<const char*>(block.bytes.data()), static_cast<std::streamsize>(block.bytes.size()));
+        written = AlignBlock(written) + block.bytes.size();
+      }
+      output.write(kPadding.data(), static_cast<std::streamsize>(fileSize - written));
+
+      if (!output.flush())
+      {
+        output.close();
+        fs::remove(temporaryPath, errorCode);
+        return false;
+      }
+    }
+
+    fs::rename(temporaryPath, cachePath, errorCode);
+    if (errorCode)
+    {
+      fs::remove(temporaryPath, errorCode);
+      return false;
+    }
+    return true;
+  }
+
+  std::optional<DecodedMesh> ReadMeshCache(const fs::path& cachePath, const ContentHash& sourceHash)
+  {
+    if constexpr (std::endian::native != std::endian::little)
+    {
+      return std::nullopt;
+    }
+
+    std::error_code errorCode;
+    if (!fs::is_regular_file(cachePath, errorCode))
+    {
+      return std::nullopt;
+    }
+
+    try
+    {
+      const MappedFile cacheFile(cachePath);
+      const auto file = std::span(reinterpret_cast<const std::uint8_t*>(cacheFile.Bytes().data()), cacheFile.Size());
+      if (file.size() < kHeaderSize ||
+          std::memcmp(file.data(), kMagic.data(), kMagic.size()) != 0 ||
+          Load<std::uint32_t>(file.data() + 8) != kMeshCacheVersion ||
+          std::memcmp(file.data() + 16, sourceHash.data(), sourceHash.size()) != 0 ||
+          Load<std::uint64_t>(file.data() + 48) != file.size() ||
+          Load<std::uint32_t>(file.data() + 56) != kDecoderRevision)
+      {
+        return std::nullopt;
+      }
+
+      return ReadBlocks(file);
+    }
+    catch (const std::exception&)
+    {
+      // Poco exceptions for unreadable or malformed files, bad_alloc for absurd sizes
+      return std::nullopt;
+    }
+  }
+}// namespace Open3SDCM::detail
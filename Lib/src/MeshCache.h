@@ -0,0 +1,75 @@
+//
+// Binary cache of decoded meshes: decode a DCM once, load it back in a few milliseconds.
+//
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "definitions.h"
+
+namespace Open3SDCM::detail
+{
+  // SHA-256 of the content of a source DCM. A cache entry is only used for the
+  // exact content it was decoded from.
+  using ContentHash = std::array<std::uint8_t, 32>;
+
+  ContentHash HashContent(std::string_view content);
+
+  // Everything DCMParser keeps from one parse
+  struct DecodedMesh
+  {
+    std::vector<float> vertices;
+    std::vector<Triangle> triangles;
+    SurfaceData surfaceData;
+    FacetDecodeInfo facetDecodeInfo;
+  };
+
+  // Cache file format, version 2 (all integers and floats little-endian):
+  //
+  //   header      64 bytes: magic "O3SDCMC\0", u32 version, u32 block count,
+  //               32-byte source ContentHash, u64 total file size,
+  //               u32 decoder revision, u32 reserved
+  //   block table one {u32 kind, u32 item, u64 offset, u64 size} per block
+  //   blocks      each starting on a 64-byte boundary
+  //
+  // Blocks: the vertices (float xyz), the triangles (u32 v1 v2 v3), the metadata
+  // (base color, facet decode info, the ids and attributes of the texture
+  // coordinate sets and images), per texture coordinate set its corner UVs
+  // (float u v) and, if some corners have none, one presence byte per corner,
+  // and per texture image its encoded bytes.
+  inline constexpr std::uint32_t kMeshCacheVersion = 2;
+
+  // Revision of the decoder output stored in an entry. Bump it with every change
+  // to what ParseDCM yields for some input (even corrupt input only), so that
+  // entries written by an older decoder are decoded again instead of served.
+  //   1: first revision recorded
+  //   2: no facet width matching facet_count keeps the 32-bit decode, not the closest
+  inline constexpr std::uint32_t kDecoderRevision = 2;
+
+  // Where the entry of `sourcePath` lives in `cacheDirectory`: the file stem plus a
+  // hash of the absolute path, so that same-named scans of different folders do not
+  // evict each other
+  std::filesystem::path MeshCachePath(const std::filesystem::path& cacheDirectory,
+                                      const std::filesystem::path& sourcePath);
+
+  // Writes to a temporary file renamed into place, so that concurrent readers see
+  // either the previous entry or the complete new one. Returns false on I/O errors
+  // and on big-endian hosts, where no cache is written.
+  bool WriteMeshCache(const std::filesystem::path& cachePath,
+                      const ContentHash& sourceHash,
+                      const std::vector<float>& vertices,
+                      const std::vector<Triangle>& triangles,
+                      const SurfaceData& surfaceData,
+                      const FacetDecodeInfo& facetDecodeInfo);
+
+  // Maps the cache file and copies its blocks out. std::nullopt when the file is
+  // missing, has another version or decoder revision, was written for other
+  // source content, or is damaged (truncated, out-of-range blocks or vertex indices).
+  std::optional<DecodedMesh> ReadMeshCache(const std::filesystem::path& cachePath,
+                                           const ContentHash& sourceHash);
+}// namespace Open3SDCM::detail
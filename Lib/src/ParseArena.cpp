@@ -0,0 +1,92 @@
+//
+// Monotonic arena for the allocations that only live during one parse.
+//
+
+#include "ParseArena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace Open3SDCM::detail
+{
+  namespace
+  {
+    // Enough for the document of a typical scan (elements, attributes, properties)
+    constexpr std::size_t kFirstBlockSize = 64 * 1024;
+    constexpr std::size_t kBlockAlignment = alignof(std::max_align_t);
+  }// namespace
+
+  ParseArena::ParseArena(std::pmr::memory_resource* upstream) : m_Upstream(upstream)
+  {
+  }
+
+  ParseArena::~ParseArena()
+  {
+    Release();
+  }
+
+  void ParseArena::Reset()
+  {
+    if (m_Blocks.size() > 1)
+    {
+      std::size_t total = 0;
+      for (const Block& block : m_Blocks)
+      {
+        total += block.size;
+      }
+      Release();
+      AddBlock(total);
+    }
+    m_Offset = 0;
+  }
+
+  void ParseArena::Release()
+  {
+    for (const Block& block : m_Blocks)
+    {
+      m_Upstream->deallocate(block.data, block.size, kBlockAlignment);
+    }
+    m_Blocks.clear();
+    m_Offset = 0;
+  }
+
+  std::size_t ParseArena::CapacityBytes() const
+  {
+    std::size_t total = 0;
+    for (const Block& block : m_Blocks)
+    {
+      total += block.size;
+    }
+    return total;
+  }
+
+  void* ParseArena::do_allocate(const std::size_t bytes, const std::size_t alignment)
+  {
+    // Only the last block has room left; earlier ones were filled before it was added
+    if (!m_Blocks.empty())
+    {
+      const Block& block = m_Blocks.back();
+      const auto address = reinterpret_cast<std::uintptr_t>(block.data) + m_Offset;
+      const std::size_t padding = (alignment - address % alignment) % alignment;
+      if (m_Offset + padding + bytes <= block.size)
+      {
+        std::byte* const pointer = block.data + m_Offset + padding;
+        m_Offset += padding + bytes;
+        return pointer;
+      }
+    }
+
+    const std::size_t lastSize = m_Blocks.empty() ? 0 : m_Blocks.back().size;
+    AddBlock(std::max(2 * lastSize, bytes + alignment));
+    std::byte* const data = m_Blocks.back().data;
+    const std::size_t padding = (alignment - reinterpret_cast<std::uintptr_t>(data) % alignment) % alignment;
+    m_Offset = padding + bytes;
+    return data + padding;
+  }
+
+  void ParseArena::AddBlock(const std::size_t minimumSize)
+  {
+    const std::size_t size = std::max(minimumSize, kFirstBlockSize);
+    m_Blocks.push_back({static_cast<std::byte*>(m_Upstream->allocate(size, kBlockAlignment)), size});
+  }
+}// namespace Open3SDCM::detail
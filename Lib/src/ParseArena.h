@@ -0,0 +1,49 @@
+//
+// Monotonic arena for the allocations that only live during one parse.
+//
+
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace Open3SDCM::detail
+{
+  // Bump allocator over blocks of an upstream resource. Deallocation does nothing;
+  // Reset() drops everything allocated since the previous Reset() at once and keeps
+  // the blocks for the next parse. A parse that overflowed the first block leaves a
+  // single block sized for all of it, so that a run of similar files stops calling
+  // the upstream resource. Not thread-safe: it serves the thread running the parse.
+  class ParseArena : public std::pmr::memory_resource
+  {
+  public:
+    explicit ParseArena(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~ParseArena() override;
+
+    ParseArena(const ParseArena&) = delete;
+    ParseArena& operator=(const ParseArena&) = delete;
+
+    void Reset();
+    // Returns every block to the upstream resource
+    void Release();
+
+    [[nodiscard]] std::size_t CapacityBytes() const;
+
+  private:
+    struct Block
+    {
+      std::byte* data;
+      std::size_t size;
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* /*pointer*/, std::size_t /*bytes*/, std::size_t /*alignment*/) override {}
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    void AddBlock(std::size_t minimumSize);
+
+    std::pmr::memory_resource* m_Upstream;
+    std::vector<Block> m_Blocks;
+    std::size_t m_Offset{0};// used bytes of the last block
+  };
+}// namespace Open3SDCM::detail
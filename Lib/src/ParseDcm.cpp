@@ -4,34 +4,45 @@
 
 #include "ParseDcm.h"
 #include "definitions.h"
+#include "DcmDocument.h"
+#include "DcmDecoders.h"
+#include "MappedFile.h"
+#include "Log.h"
+#include "MeshCache.h"
+#include "ParseArena.h"
+#include "StatsCollector.h"
+#include "Base64.h"
+#include "ThreadPool.h"
+#include "CeKey.h"
 
 #include "boost/dynamic_bitset.hpp"
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
 #include <deque>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
-#include <iostream>
+#include <functional>
+#include <iterator>
 #include <sstream>
 #include <string>
+#include <limits>
 #include <map>
-#include <set>
-#include <iomanip>
+#include <memory>
 #include <charconv>
 #include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <unordered_map>
 
 #include <openssl/blowfish.h>
-#include <openssl/md5.h>
 
-#include "Poco/Base64Decoder.h"
 #include "Poco/Checksum.h"
-#include <Poco/DOM/AutoPtr.h>
-#include <Poco/DOM/DOMParser.h>
-#include <Poco/DOM/Document.h>
-#include <Poco/DOM/Element.h>
-#include <Poco/DOM/NodeList.h>
-#include <Poco/DOM/Text.h>
 #include <Poco/Exception.h>
 #include <Poco/File.h>
 #include <Poco/Path.h>
@@ -41,6 +52,8 @@
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+#include <fmt/compile.h>
+#include <fmt/format.h>
 #include <fmt/ostream.h>
 
 namespace fs = std::filesystem;
@@ -50,109 +63,92 @@ namespace Open3SDCM
 
   namespace detail
   {
-    size_t GetElemCount(Poco::AutoPtr<Poco::XML::NodeList> BinaryNodes, const std::string& GeomType)
+    size_t GetElemCount(const std::optional<DcmElement>& GeomElement, const std::string& GeomType)
     {
-      try
+      if (!GeomElement.has_value())
       {
-        if (!BinaryNodes.isNull() && BinaryNodes->length() > 0)
-        {
-          auto binaryElement = dynamic_cast<Poco::XML::Element*>(BinaryNodes->item(0));
-          if (binaryElement)
-          {
-            // Get the CA element inside Binary_data
-
-            Poco::AutoPtr<Poco::XML::NodeList> caNodes = binaryElement->getElementsByTagName(GeomType);
-            if (caNodes->length() > 0)
-            {
-              auto caElement = dynamic_cast<Poco::XML::Element*>(caNodes->item(0));
-
-              std::string AttrName = GeomType == "Vertices" ? "vertex_count" : "facet_count";
-              std::string StrCount = caElement->getAttribute(AttrName);
-              size_t Count;
-              std::from_chars(StrCount.data(), StrCount.data() + StrCount.size(), Count);
-              return Count;
-            }
-          }
-        }
         return 0;
       }
-      catch (const Poco::Exception& ex)
+
+      const std::string_view AttrName = GeomType == "Vertices" ? "vertex_count" : "facet_count";
+      const std::string_view StrCount = GeomElement->GetAttribute(AttrName);
+      size_t Count = 0;
+      std::from_chars(StrCount.data(), StrCount.data() + StrCount.size(), Count);
+      return Count;
+    }
+
+    // Sizes a buffer that may be recycled from a previous file; only growing past
+    // its capacity allocates (and counts in the parse stats)
+    template <typename T>
+    void ResizeRecycled(std::vector<T>& buffer, const std::size_t size)
+    {
+      if (size > buffer.capacity())
       {
-        std::cerr << "Error getting vertex count: " << ex.displayText() << std::endl;
-        return 0;
+        RecordBuffer(size * sizeof(T));
       }
+      buffer.resize(size);
     }
 
-    size_t GetBufferSize(Poco::AutoPtr<Poco::XML::NodeList> BinaryNodes, const std::string& GeomType)
+    template <typename T>
+    void ReserveRecycled(std::vector<T>& buffer, const std::size_t capacity)
     {
-      try
+      if (capacity > buffer.capacity())
       {
-        if (!BinaryNodes.isNull() && BinaryNodes->length() > 0)
-        {
-          auto binaryElement = dynamic_cast<Poco::XML::Element*>(BinaryNodes->item(0));
-          if (binaryElement)
-          {
-            // Get the CA element inside Binary_data
+        RecordBuffer(capacity * sizeof(T));
+        buffer.reserve(capacity);
+      }
+    }
 
-            Poco::AutoPtr<Poco::XML::NodeList> caNodes = binaryElement->getElementsByTagName(GeomType);
-            if (caNodes->length() > 0)
-            {
-              auto caElement = dynamic_cast<Poco::XML::Element*>(caNodes->item(0));
+    template <typename ByteT>
+    void DecodeBufferInto(std::string_view base64Text, std::vector<ByteT>& rawData)
+    {
+      static_assert(sizeof(ByteT) == 1);
+      // Decode straight out of the document text; blankspace and line breaks are skipped inline
+      ResizeRecycled(rawData, base64::MaxDecodedSize(base64Text.size()) + base64::kOutputSlack);
+      const std::size_t decodedSize = base64::Decode(base64Text, reinterpret_cast<std::uint8_t*>(rawData.data()));
+      rawData.resize(decodedSize);
+    }
 
-              std::string StrBuffersize = caElement->getAttribute("base64_encoded_bytes");
-              size_t Count;
-              std::from_chars(StrBuffersize.data(), StrBuffersize.data() + StrBuffersize.size(), Count);
-              return Count;
-            }
-          }
-        }
-        return 0;
-      }
-      catch (const Poco::Exception& ex)
-      {
-        std::cerr << "Error getting vertex count: " << ex.displayText() << std::endl;
-        return 0;
-      }
+    // DecodeBufferInto, timed as the base64 stage
+    void DecodePayloadBuffer(std::string_view base64Text, std::vector<char>& rawData)
+    {
+      StageTimer timer(ParseStage::Base64Decode);
+      DecodeBufferInto(base64Text, rawData);
+      timer.AddBytes(rawData.size());
     }
 
-    std::vector<char> DecodeBuffer(std::string& base64Text, size_t EstimatedBufferSize)
+    std::vector<char> DecodeBuffer(std::string_view base64Text)
     {
-      // remove blankspace and empty lines
-      std::erase_if(base64Text, [](char c) { return c == ' ' || c == '\n' || c == '\r'; });
-      std::istringstream inStream(base64Text);
-      std::ostringstream outStream;
-      Poco::Base64Decoder decoder(inStream);
       std::vector<char> rawData;
-      rawData.reserve(EstimatedBufferSize);
-      std::array<char, 4096U> chunk;
-      while (decoder.read(chunk.data(), sizeof(chunk)))
-      {
-        rawData.insert(rawData.end(), chunk.begin(), chunk.begin() + decoder.gcount());
-      }
-      if (decoder.gcount() > 0)
-      {
-        rawData.insert(rawData.end(), chunk.begin(), chunk.begin() + decoder.gcount());
-      }
+      DecodePayloadBuffer(base64Text, rawData);
       return rawData;
     }
 
-    std::optional<std::string> GetOptionalAttribute(const Poco::XML::Element& element, const std::string& attributeName)
+    // View of a non-empty attribute, valid as long as the element
+    std::optional<std::string_view> GetOptionalAttributeView(const DcmElement& element, std::string_view attributeName)
     {
-      if (!element.hasAttribute(attributeName))
+      const std::string_view value = element.GetAttribute(attributeName);
+      if (value.empty())
       {
         return std::nullopt;
       }
 
-      std::string value = element.getAttribute(attributeName);
-      if (value.empty())
+      return value;
+    }
+
+    // Copy of a non-empty attribute, for the parse results
+    std::optional<std::string> GetOptionalAttribute(const DcmElement& element, std::string_view attributeName)
+    {
+      const auto value = GetOptionalAttributeView(element, attributeName);
+      if (!value.has_value())
       {
         return std::nullopt;
       }
 
-      return value;
+      return std::string(*value);
     }
 
-    std::optional<std::size_t> ParseSizeT(const std::string& value)
+    std::optional<std::size_t> ParseSizeT(std::string_view value)
     {
       std::size_t parsedValue = 0;
       const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), parsedValue);
@@ -164,7 +160,7 @@ namespace Open3SDCM
       return parsedValue;
     }
 
-    std::optional<std::uint32_t> ParseUint32(const std::string& value)
+    std::optional<std::uint32_t> ParseUint32(std::string_view value)
     {
       std::uint32_t parsedValue = 0;
       const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), parsedValue);
@@ -176,9 +172,9 @@ namespace Open3SDCM
       return parsedValue;
     }
 
-    std::optional<std::size_t> GetOptionalSizeTAttribute(const Poco::XML::Element& element, const std::string& attributeName)
+    std::optional<std::size_t> GetOptionalSizeTAttribute(const DcmElement& element, std::string_view attributeName)
     {
-      const auto value = GetOptionalAttribute(element, attributeName);
+      const auto value = GetOptionalAttributeView(element, attributeName);
       if (!value.has_value())
       {
         return std::nullopt;
@@ -196,536 +192,775 @@ namespace Open3SDCM
       };
     }
 
-    Poco::XML::Element* FindFirstDirectChildElement(Poco::XML::Node* parent, const std::string& elementName)
+    std::uint32_t LoadLittleEndian32(const std::uint8_t* bytes)
+    {
+      return static_cast<std::uint32_t>(bytes[0]) | (static_cast<std::uint32_t>(bytes[1]) << 8U) |
+             (static_cast<std::uint32_t>(bytes[2]) << 16U) | (static_cast<std::uint32_t>(bytes[3]) << 24U);
+    }
+
+    void StoreLittleEndian32(std::uint8_t* bytes, const std::uint32_t value)
     {
-      if (parent == nullptr)
+      bytes[0] = static_cast<std::uint8_t>(value);
+      bytes[1] = static_cast<std::uint8_t>(value >> 8U);
+      bytes[2] = static_cast<std::uint8_t>(value >> 16U);
+      bytes[3] = static_cast<std::uint8_t>(value >> 24U);
+    }
+
+    // Decrypts whole 8-byte blocks in place. CE stores each block as two
+    // little-endian words, whereas BF_ecb_encrypt reads them big-endian, so the
+    // words are loaded and stored explicitly around BF_decrypt.
+    void DecryptCeBlocks(std::uint8_t* data, const std::size_t size, const BF_KEY& bfKey)
+    {
+      for (std::size_t i = 0; i + 8 <= size; i += 8)
       {
-        return nullptr;
+        BF_LONG block[2] = {LoadLittleEndian32(data + i), LoadLittleEndian32(data + i + 4)};
+        BF_decrypt(block, &bfKey);
+        StoreLittleEndian32(data + i, block[0]);
+        StoreLittleEndian32(data + i + 4, block[1]);
       }
+    }
 
-      for (auto child = parent->firstChild(); child != nullptr; child = child->nextSibling())
-      {
-        if (child->nodeType() != Poco::XML::Node::ELEMENT_NODE)
-        {
-          continue;
-        }
+    // Payloads below this size are decrypted on the calling thread
+    constexpr std::size_t kParallelDecryptThreshold = 256U * 1024U;
+    constexpr std::size_t kParallelDecryptGrain = 64U * 1024U;
 
-        if (child->nodeName() == elementName)
+    std::vector<char> DecryptBuffer(std::vector<char> data,
+                                    std::string_view schema,
+                                    const PropertyMap& props,
+                                    const bool scrambleKey,
+                                    const std::size_t truncateSize)
+    {
+      if (schema != "CE")
+      {
+        if (truncateSize > 0 && data.size() > truncateSize)
         {
-          return dynamic_cast<Poco::XML::Element*>(child);
+          data.resize(truncateSize);
         }
+        return data;
       }
 
-      return nullptr;
-    }
-
-    std::string ComputePackageLockHash(const std::map<std::string, std::string>& props)
-    {
-      auto it = props.find("PackageLockList");
-      if (it == props.end()) return "";
-
-      std::string value = it->second;
-      if (value.empty()) return "";
+      const StageTimer timer(ParseStage::Decrypt, data.size());
+      const auto bfKey = CeKeyCache::Shared().Get(props, scrambleKey);
 
-      std::set<std::string> items;
-      std::stringstream ss(value);
-      std::string item;
-      while (std::getline(ss, item, ';')) {
-        if (!item.empty()) items.insert(item);
+      if (data.size() % 8 != 0)
+      {
+        const std::size_t padding = 8 - (data.size() % 8);
+        data.resize(data.size() + padding, 0);
       }
 
-      if (items.empty()) return "";
-
-      std::string canonical;
-      for (const auto& i : items) {
-        canonical += i + ";";
+      // ECB has no chaining: large payloads are split into independent block ranges
+      auto* bytes = reinterpret_cast<std::uint8_t*>(data.data());
+      if (data.size() < kParallelDecryptThreshold)
+      {
+        DecryptCeBlocks(bytes, data.size(), *bfKey);
       }
-
-      unsigned char digest[MD5_DIGEST_LENGTH];
-      MD5((unsigned char*)canonical.c_str(), canonical.length(), digest);
-
-      std::stringstream hex;
-      hex << std::hex << std::uppercase;
-      for(int i = 0; i < MD5_DIGEST_LENGTH; ++i)
-        hex << std::setw(2) << std::setfill('0') << (int)digest[i];
-
-      return hex.str();
-    }
-
-    void SwapEndianness(std::vector<char>& data)
-    {
-      for (size_t i = 0; i + 8 <= data.size(); i += 8)
+      else
       {
-           // Swap two 32-bit integers from LE to BE (or vice versa)
-           // [0 1 2 3] [4 5 6 7] -> [3 2 1 0] [7 6 5 4]
-           std::swap(data[i+0], data[i+3]);
-           std::swap(data[i+1], data[i+2]);
+        ParallelFor(data.size() / 8, kParallelDecryptGrain / 8, [&](const std::size_t beginBlock, const std::size_t endBlock)
+        {
+          DecryptCeBlocks(bytes + beginBlock * 8, (endBlock - beginBlock) * 8, *bfKey);
+        });
+      }
 
-           std::swap(data[i+4], data[i+7]);
-           std::swap(data[i+5], data[i+6]);
+      if (truncateSize > 0 && data.size() > truncateSize)
+      {
+        data.resize(truncateSize);
       }
+
+      return data;
     }
 
-    std::vector<unsigned char> BuildCeKey(const std::map<std::string, std::string>& props, const bool scramble)
+    // Streams a base64 payload into `output`: the text is decoded one L1-sized
+    // block at a time and, for CE payloads (bfKey set), each block is decrypted
+    // and fed to `checksum` while still hot, then copied once into `output`.
+    // Plain payloads are decoded straight into `output`, except for the last
+    // block which goes through the staging buffer (the decoder writes past its
+    // limit). Bytes decoded past output.size() are dropped, like DecryptBuffer's
+    // truncation. Returns the number of bytes written to `output`.
+    std::size_t DecodePayloadInto(std::string_view base64Text,
+                                  const BF_KEY* bfKey,
+                                  std::span<std::byte> output,
+                                  Poco::Checksum* checksum)
     {
-      std::vector<unsigned char> key = {
-        0x34, 0x90, 0x02, 0x93, 0x58, 0x2F, 0x49, 0x94,
-        0x76, 0x02, 0x19, 0xDF, 0x3B, 0x56, 0x44, 0x1C
-      };
-
-      std::string ekid = "1";
-      const auto ekidIt = props.find("EKID");
-      if (ekidIt != props.end())
-      {
-        ekid = ekidIt->second;
+      // Multiple of 3 (whole base64 quanta) and of 8 (whole Blowfish blocks)
+      constexpr std::size_t kBlockSize = 4080U;
+      alignas(32) std::array<std::uint8_t, kBlockSize + base64::kOutputSlack> block;
+
+      base64::StreamDecoder decoder(base64Text);
+      std::size_t written = 0;
+      // Looked up once: the block loop is too hot for a thread_local access per stage
+      StatsCollector* const stats = BoundStatsCollector();
+
+      if (bfKey == nullptr && checksum == nullptr && output.size() > base64::kOutputSlack)
+      {
+        const std::size_t direct = ((output.size() - base64::kOutputSlack) / 3U) * 3U;
+        StageTimer timer(stats, ParseStage::Base64Decode);
+        written = decoder.Read(reinterpret_cast<std::uint8_t*>(output.data()), direct);
+        timer.AddBytes(written);
+        timer.Stop();
+        if (written < direct)
+        {
+          return written;
+        }
       }
 
-      const std::string packageHash = ComputePackageLockHash(props);
-      std::vector<unsigned char> finalKey = key;
-      if (ekid == "1" && !packageHash.empty())
+      while (written < output.size())
       {
-        for (const char c : packageHash)
+        std::size_t decoded = 0;
         {
-          finalKey.push_back(static_cast<unsigned char>(c));
+          StageTimer timer(stats, ParseStage::Base64Decode);
+          decoded = decoder.Read(block.data(), kBlockSize);
+          timer.AddBytes(decoded);
+        }
+        if (decoded == 0)
+        {
+          break;
         }
-      }
 
-      if (scramble)
-      {
-        std::reverse(finalKey.begin(), finalKey.end());
-        for (auto& byte : finalKey)
+        std::size_t produced = decoded;
+        if (bfKey != nullptr)
         {
-          byte ^= 0x7BU;
+          // A trailing partial Blowfish block is zero-padded, as in DecryptBuffer
+          produced = (decoded + 7U) & ~std::size_t{7U};
+          const StageTimer timer(stats, ParseStage::Decrypt, produced);
+          std::fill(block.begin() + static_cast<std::ptrdiff_t>(decoded), block.begin() + static_cast<std::ptrdiff_t>(produced), std::uint8_t{0});
+          DecryptCeBlocks(block.data(), produced, *bfKey);
         }
-      }
 
-      return finalKey;
+        const std::size_t kept = std::min(produced, output.size() - written);
+        if (checksum != nullptr)
+        {
+          const StageTimer timer(stats, ParseStage::Checksum, kept);
+          checksum->update(reinterpret_cast<const char*>(block.data()), static_cast<unsigned int>(kept));
+        }
+        std::memcpy(output.data() + written, block.data(), kept);
+        written += kept;
+
+        if (decoded < kBlockSize)
+        {
+          break;
+        }
+      }
+      return written;
     }
 
-    std::vector<char> DecryptBuffer(std::vector<char> data,
-                                    const std::string& schema,
-                                    const std::map<std::string, std::string>& props,
-                                    const bool scrambleKey = false,
-                                    const std::size_t truncateSize = 0)
+    // HPS floats are little-endian; only big-endian hosts need to touch them
+    void LittleEndianToHost(std::span<float> values)
     {
-      if (schema != "CE")
+      if constexpr (std::endian::native == std::endian::big)
       {
-        if (truncateSize > 0 && data.size() > truncateSize)
+        for (float& value : values)
         {
-          data.resize(truncateSize);
+          std::uint8_t bytes[sizeof(float)];
+          std::memcpy(bytes, &value, sizeof(float));
+          const std::uint32_t bits = LoadLittleEndian32(bytes);
+          std::memcpy(&value, &bits, sizeof(float));
         }
-        return data;
       }
+    }
 
-      const auto finalKey = BuildCeKey(props, scrambleKey);
-
-      BF_KEY bfKey;
-      BF_set_key(&bfKey, finalKey.size(), finalKey.data());
+    // The CE check_value is the byte-swapped Adler32 of the decrypted payload
+    void VerifyCeChecksum(const DcmElement& element, const std::uint32_t adler)
+    {
+      if (!element.HasAttribute("check_value"))
+      {
+        return;
+      }
 
-      if (data.size() % 8 != 0)
+      const std::string_view checkValueStr = element.GetAttribute("check_value");
+      uint32_t checkValue = 0;
+      auto [ptr, ec] = std::from_chars(checkValueStr.data(), checkValueStr.data() + checkValueStr.size(), checkValue);
+      if (ec != std::errc())
       {
-        const std::size_t padding = 8 - (data.size() % 8);
-        data.resize(data.size() + padding, 0);
+        return;
       }
 
-      SwapEndianness(data);
+      // Swap endianness to match reference implementation
+      uint32_t swappedAdler = ((adler & 0xFF000000) >> 24) |
+                              ((adler & 0x00FF0000) >> 8)  |
+                              ((adler & 0x0000FF00) << 8)  |
+                              ((adler & 0x000000FF) << 24);
 
-      std::vector<char> decrypted(data.size());
-      for (size_t i = 0; i < data.size(); i += 8)
-      {
-        BF_ecb_encrypt(reinterpret_cast<unsigned char*>(&data[i]),
-                       reinterpret_cast<unsigned char*>(&decrypted[i]),
-                       &bfKey,
-                       BF_DECRYPT);
+      if (swappedAdler != checkValue) {
+          O3SDCM_LOG_ERROR("CE schema checksum mismatch! Expected: {}, got: {}. Decryption key may be incorrect.", checkValue, swappedAdler);
       }
+    }
 
-      SwapEndianness(decrypted);
-      if (truncateSize > 0 && decrypted.size() > truncateSize)
+    // Decodes the vertex payload straight into `output` (x, y, z per vertex),
+    // decrypting and verifying it for the CE schema. Returns the number of
+    // floats filled.
+    std::size_t DecodeVertices(const DcmElement& VerticesElement,
+                               std::string_view schema,
+                               const PropertyMap& props,
+                               std::span<float> output)
+    {
+      const auto outputBytes = std::as_writable_bytes(output);
+      std::size_t decodedSize = 0;
+      if (schema == "CE")
       {
-        decrypted.resize(truncateSize);
+        const auto bfKey = CeKeyCache::Shared().Get(props, false);
+        Poco::Checksum checksum(Poco::Checksum::TYPE_ADLER32);
+        decodedSize = DecodePayloadInto(VerticesElement.InnerText(), bfKey.get(), outputBytes, &checksum);
+        VerifyCeChecksum(VerticesElement, checksum.checksum());
+      }
+      else
+      {
+        decodedSize = DecodePayloadInto(VerticesElement.InnerText(), nullptr, outputBytes, nullptr);
       }
 
-      return decrypted;
+      const std::size_t floatCount = decodedSize / sizeof(float);
+      LittleEndianToHost(output.first(floatCount));
+      return floatCount;
     }
 
-    std::vector<float> ParseVertices(Poco::AutoPtr<Poco::XML::NodeList> BinaryNodes, const std::string& schema, const std::map<std::string, std::string>& props)
+    // Sizes `vertices` once for vertex_count and decodes into it in place
+    bool ParseVertices(const std::optional<DcmElement>& VerticesElement,
+                       std::string_view schema,
+                       const PropertyMap& props,
+                       std::vector<float>& vertices)
     {
+      vertices.clear();
       try
       {
-        if (!BinaryNodes.isNull() && BinaryNodes->length() > 0)
+        if (!VerticesElement.has_value())
         {
-          auto binaryElement = dynamic_cast<Poco::XML::Element*>(BinaryNodes->item(0));
-          if (binaryElement)
-          {
-            // Get the CA element inside Binary_data
-
-            Poco::AutoPtr<Poco::XML::NodeList> caNodes = binaryElement->getElementsByTagName("Vertices");
-            if (caNodes->length() > 0)
-            {
+          return false;
+        }
 
-              auto caElement = dynamic_cast<Poco::XML::Element*>(caNodes->item(0));
-              std::string base64Text = caElement->innerText();
-
-              auto BufferSize = GetBufferSize(BinaryNodes, "Vertices");
-              auto rawData = DecodeBuffer(base64Text, BufferSize);
-
-              auto vertexCount = GetElemCount(BinaryNodes, "Vertices");
-              const std::size_t expectedSize = vertexCount * 3 * sizeof(float);
-              rawData = DecryptBuffer(std::move(rawData), schema, props, false, expectedSize);
-
-              // Verify checksum for CE schema
-              if (schema == "CE" && caElement->hasAttribute("check_value")) {
-                  std::string checkValueStr = caElement->getAttribute("check_value");
-                  uint32_t checkValue = 0;
-                  auto [ptr, ec] = std::from_chars(checkValueStr.data(), checkValueStr.data() + checkValueStr.size(), checkValue);
-
-                  if (ec == std::errc()) {
-                      Poco::Checksum checksum(Poco::Checksum::TYPE_ADLER32);
-                      checksum.update(rawData.data(), rawData.size());
-                      uint32_t adler = checksum.checksum();
-
-                      // Swap endianness to match reference implementation
-                      uint32_t swappedAdler = ((adler & 0xFF000000) >> 24) |
-                                              ((adler & 0x00FF0000) >> 8)  |
-                                              ((adler & 0x0000FF00) << 8)  |
-                                              ((adler & 0x000000FF) << 24);
-
-                      if (swappedAdler != checkValue) {
-                          std::cerr << "Error: CE schema checksum mismatch! Expected: " << checkValue
-                                    << ", got: " << swappedAdler << ". Decryption key may be incorrect." << std::endl;
-                      }
-                  }
-              }
-
-              // Reinterpret the raw bytes as floats
-              auto floatPtr = reinterpret_cast<const float*>(rawData.data());
-              std::size_t floatCount = vertexCount * 3;
-
-              // Ensure we don't read past buffer
-              if (floatCount * sizeof(float) > rawData.size()) {
-                  std::cerr << "Error: Decrypted buffer too small for vertex count" << std::endl;
-                  return {};
-              }
-
-              std::vector<float> floatData(floatPtr, floatPtr + floatCount);
-
-              return floatData;
-            }
-          }
+        // vertex_count is untrusted: bound it by what the payload can decode to
+        // before sizing, which also keeps vertexCount * 3 from overflowing
+        const auto vertexCount = GetElemCount(VerticesElement, "Vertices");
+        const std::size_t maxVertexCount = base64::MaxDecodedSize(VerticesElement->InnerText().size()) / (3 * sizeof(float));
+        if (vertexCount > maxVertexCount)
+        {
+          O3SDCM_LOG_ERROR("vertex_count {} exceeds the {} vertices the payload can hold", vertexCount, maxVertexCount);
+          return false;
         }
-        return {};
+        ResizeRecycled(vertices, vertexCount * 3);
+        if (DecodeVertices(*VerticesElement, schema, props, vertices) < vertices.size())
+        {
+          O3SDCM_LOG_ERROR("Decrypted buffer too small for vertex count");
+          vertices.clear();
+          return false;
+        }
+        return true;
       }
       catch (const Poco::Exception& ex)
       {
-
-        return {};
+        vertices.clear();
+        return false;
       }
     }
 
-    std::vector<Open3SDCM::Triangle> InterpretFacetsBuffer(const std::vector<char>& rawData, size_t expectedFaceCount)
+    // Active boundary of the facet decoder: a circular doubly-linked list of
+    // edges whose nodes live in one pooled vector and are linked by index, so
+    // every opcode is O(1). Removed nodes go to a free list for reuse; a restart
+    // drops the whole ring at once.
+    class EdgeRing
     {
-      // Edge in the circular edge list
+    public:
+      using VertexIndex = Open3SDCM::Triangle::index_type;
+
       struct Edge
       {
-        size_t start;
-        size_t end;
+        VertexIndex start;
+        VertexIndex end;
       };
 
-      // Run the full decode with a given payload width for opcodes 5 and 7.
-      // Returns the produced triangles so we can retry with a different mode.
-      auto decode = [&](bool use32BitPayload) -> std::vector<Open3SDCM::Triangle> {
-        std::vector<Open3SDCM::Triangle> triangles;
-        triangles.reserve(expectedFaceCount);
+      using NodeId = std::uint32_t;
+      static constexpr NodeId kNoNode = std::numeric_limits<NodeId>::max();
 
-        std::vector<Edge> edgeList;
-        size_t currentEdgeIdx  = 0;
-        size_t globalVertexPtr = 0;
-        size_t offset          = 0;
+      void Reserve(const std::size_t capacity) { m_Nodes.reserve(capacity); }
+      [[nodiscard]] std::size_t CapacityBytes() const { return m_Nodes.capacity() * sizeof(Node); }
 
-        // ── helpers ──────────────────────────────────────────────────────────
+      // Empties the ring; the node pool keeps its capacity
+      void Clear()
+      {
+        m_Nodes.clear();
+        m_FreeHead = kNoNode;
+        m_Size = 0;
+      }
 
-        auto requireBytes = [&](size_t n) -> bool {
-          return offset + n <= rawData.size();
-        };
+      void Release()
+      {
+        Clear();
+        m_Nodes.shrink_to_fit();
+      }
 
-        auto readUint16 = [&]() -> size_t {
-          uint16_t v = 0;
-          std::memcpy(&v, &rawData[offset], sizeof(v));
-          offset += sizeof(v);
-          return static_cast<size_t>(v);
-        };
+      [[nodiscard]] bool Empty() const { return m_Size == 0; }
+      [[nodiscard]] std::size_t Size() const { return m_Size; }
 
-        auto readUint32 = [&]() -> size_t {
-          uint32_t v = 0;
-          std::memcpy(&v, &rawData[offset], sizeof(v));
-          offset += sizeof(v);
-          return static_cast<size_t>(v);
-        };
+      Edge& operator[](const NodeId node) { return m_Nodes[node].edge; }
+      [[nodiscard]] NodeId Next(const NodeId node) const { return m_Nodes[node].next; }
+      [[nodiscard]] NodeId Prev(const NodeId node) const { return m_Nodes[node].prev; }
 
-        // Read one index according to the current payload mode
-        auto readIdx = [&]() -> size_t {
-          return use32BitPayload ? readUint32() : readUint16();
-        };
+      // Replaces the ring by the three edges of a new face; returns the first one
+      NodeId Reset(const Edge& e0, const Edge& e1, const Edge& e2)
+      {
+        Clear();
+        m_Nodes.push_back({e0, 2, 1});
+        m_Nodes.push_back({e1, 0, 2});
+        m_Nodes.push_back({e2, 1, 0});
+        m_Size = 3;
+        return 0;
+      }
 
-        auto advanceEdgePointer = [&](size_t n = 1) {
-          if (!edgeList.empty())
-            currentEdgeIdx = (currentEdgeIdx + n) % edgeList.size();
-        };
+      NodeId InsertAfter(const NodeId node, const Edge& edge)
+      {
+        const NodeId next = m_Nodes[node].next;
+        NodeId inserted = m_FreeHead;
+        if (inserted != kNoNode)
+        {
+          m_FreeHead = m_Nodes[inserted].next;
+          m_Nodes[inserted] = {edge, node, next};
+        }
+        else
+        {
+          inserted = static_cast<NodeId>(m_Nodes.size());
+          m_Nodes.push_back({edge, node, next});
+        }
+        m_Nodes[node].next = inserted;
+        m_Nodes[next].prev = inserted;
+        ++m_Size;
+        return inserted;
+      }
 
-        auto createRestartFace = [&](size_t v0, size_t v1, size_t v2) {
-          triangles.push_back({v0, v1, v2});
-          edgeList       = {{v0, v1}, {v1, v2}, {v2, v0}};
-          currentEdgeIdx = 0;
-        };
+      void Remove(const NodeId node)
+      {
+        const NodeId prev = m_Nodes[node].prev;
+        const NodeId next = m_Nodes[node].next;
+        m_Nodes[prev].next = next;
+        m_Nodes[next].prev = prev;
+        m_Nodes[node].next = m_FreeHead;
+        m_FreeHead = node;
+        --m_Size;
+      }
 
-        auto extendCurrentEdge = [&](size_t v) {
-          if (edgeList.empty())
-            return;
-          Edge curr = edgeList[currentEdgeIdx];
-          triangles.push_back({v, curr.end, curr.start});
-          edgeList.erase(edgeList.begin() + static_cast<std::ptrdiff_t>(currentEdgeIdx));
-          edgeList.insert(edgeList.begin() + static_cast<std::ptrdiff_t>(currentEdgeIdx),
-                          Edge{v, curr.end});
-          edgeList.insert(edgeList.begin() + static_cast<std::ptrdiff_t>(currentEdgeIdx),
-                          Edge{curr.start, v});
-        };
+    private:
+      struct Node
+      {
+        Edge edge;
+        NodeId prev;
+        NodeId next;
+      };
 
-        auto handlePrevious = [&]() {
-          if (edgeList.size() < 2)
-            return;
-          const size_t n       = edgeList.size();
-          const size_t prevIdx = (currentEdgeIdx + n - 1) % n;
-          const size_t currIdx = currentEdgeIdx;
-
-          Edge prevEdge = edgeList[prevIdx];
-          Edge currEdge = edgeList[currIdx];
-          triangles.push_back({currEdge.start, prevEdge.start, currEdge.end});
-
-          Edge newEdge             = {prevEdge.start, currEdge.end};
-          const size_t highIdx     = std::max(currIdx, prevIdx);
-          const size_t lowIdx      = std::min(currIdx, prevIdx);
-          edgeList.erase(edgeList.begin() + static_cast<std::ptrdiff_t>(highIdx));
-          edgeList.erase(edgeList.begin() + static_cast<std::ptrdiff_t>(lowIdx));
-          edgeList.insert(edgeList.begin() + static_cast<std::ptrdiff_t>(lowIdx), newEdge);
-          currentEdgeIdx = (lowIdx + 1) % edgeList.size();
-        };
+      std::vector<Node> m_Nodes;
+      NodeId m_FreeHead{kNoNode};
+      std::size_t m_Size{0};
+    };
 
-        auto handleNext = [&]() {
-          if (edgeList.size() < 2)
-            return;
-          const size_t currIdx = currentEdgeIdx;
-          const size_t nextIdx = (currIdx + 1) % edgeList.size();
-
-          Edge currEdge = edgeList[currIdx];
-          Edge nextEdge = edgeList[nextIdx];
-          triangles.push_back({currEdge.start, nextEdge.end, currEdge.end});
-
-          Edge newEdge             = {currEdge.start, nextEdge.end};
-          const size_t highIdx     = std::max(currIdx, nextIdx);
-          const size_t lowIdx      = std::min(currIdx, nextIdx);
-          edgeList.erase(edgeList.begin() + static_cast<std::ptrdiff_t>(highIdx));
-          edgeList.erase(edgeList.begin() + static_cast<std::ptrdiff_t>(lowIdx));
-          edgeList.insert(edgeList.begin() + static_cast<std::ptrdiff_t>(lowIdx), newEdge);
-          currentEdgeIdx = (lowIdx + 1) % edgeList.size();
-        };
+    // Early-abort bound shared by the prescan and the decoder: a wrong payload
+    // width shows up as too many faces or an absurdly long boundary
+    bool IsRunaway(const std::size_t expectedFaceCount, const std::size_t faceCount, const std::size_t boundarySize)
+    {
+      return expectedFaceCount > 0 &&
+             (faceCount > expectedFaceCount + expectedFaceCount / 10 ||
+              boundarySize > expectedFaceCount / 4 + 1000);
+    }
 
-        auto removeCurrentEdge = [&]() {
-          if (edgeList.empty())
-            return;
-          const size_t n       = edgeList.size();
-          const size_t prevIdx = (currentEdgeIdx + n - 1) % n;
-          const size_t currIdx = currentEdgeIdx;
-
-          Edge prevEdge = edgeList[prevIdx];
-          Edge currEdge = edgeList[currIdx];
-
-          if (prevEdge.start == currEdge.end && n > 2) {
-            const size_t highIdx = std::max(currIdx, prevIdx);
-            const size_t lowIdx  = std::min(currIdx, prevIdx);
-            edgeList.erase(edgeList.begin() + static_cast<std::ptrdiff_t>(highIdx));
-            edgeList.erase(edgeList.begin() + static_cast<std::ptrdiff_t>(lowIdx));
-            if (!edgeList.empty()) {
-              const size_t newPrevIdx = (lowIdx + edgeList.size() - 1) % edgeList.size();
-              const size_t newCurrIdx = lowIdx % edgeList.size();
-              edgeList[newPrevIdx].end = edgeList[newCurrIdx].start;
-              currentEdgeIdx           = newCurrIdx;
-            } else {
-              currentEdgeIdx = 0;
-            }
-          } else {
-            edgeList[prevIdx].end = currEdge.end;
-            edgeList.erase(edgeList.begin() + static_cast<std::ptrdiff_t>(currIdx));
-            currentEdgeIdx = edgeList.empty() ? 0 : currIdx % edgeList.size();
-          }
-        };
+    // Full decode with a given payload width for opcodes 5 and 7, into `triangles`
+    // (emptied first). Both buffers may be recycled from a previous decode.
+    void DecodeFacets(const std::vector<char>& rawData,
+                      const size_t expectedFaceCount,
+                      const bool use32BitPayload,
+                      EdgeRing& edgeRing,
+                      std::vector<Open3SDCM::Triangle>& triangles)
+    {
+      using Edge = EdgeRing::Edge;
 
-        // ── main decode loop ─────────────────────────────────────────────────
+      triangles.clear();
+      ReserveRecycled(triangles, expectedFaceCount);
 
-        while (offset < rawData.size()) {
-          // Early-abort when clearly in the wrong mode:
-          // face count >10% over expected, OR edge list grown absurdly large
-          // (both happen when the wrong payload width misinterprets the byte stream)
-          if (expectedFaceCount > 0 &&
-              (triangles.size() > expectedFaceCount + expectedFaceCount / 10 ||
-               edgeList.size() > expectedFaceCount / 4 + 1000))
-            break;
+      edgeRing.Clear();
+      edgeRing.Reserve(1024);
+      EdgeRing::NodeId currentEdge = EdgeRing::kNoNode;
+      using VertexIndex = Open3SDCM::Triangle::index_type;
+      VertexIndex globalVertexPtr = 0;
+      size_t offset               = 0;
 
-          const uint8_t opcode = static_cast<uint8_t>(rawData[offset]) & 0x0F;
-          offset++;
+      // ── helpers ──────────────────────────────────────────────────────────
 
-          switch (opcode) {
-            case 0: { // VERTEX_LIST
-              extendCurrentEdge(globalVertexPtr++);
-              advanceEdgePointer(2);
-              break;
-            }
-            case 1: { // PREVIOUS
-              handlePrevious();
-              break;
-            }
-            case 2: { // NEXT
-              handleNext();
-              break;
-            }
-            case 3: { // IGNORE
-              advanceEdgePointer(1);
-              break;
-            }
-            case 4: { // RESTART
-              const size_t v0 = globalVertexPtr++;
-              const size_t v1 = globalVertexPtr++;
-              const size_t v2 = globalVertexPtr++;
-              createRestartFace(v0, v1, v2);
-              break;
-            }
-            case 5: { // RESTART_16 — payload width depends on mode
-              if (!requireBytes(use32BitPayload ? 12 : 6)) break;
-              createRestartFace(readIdx(), readIdx(), readIdx());
-              break;
-            }
-            case 6: { // RESTART_32 — always 32-bit
-              if (!requireBytes(12)) break;
-              createRestartFace(readUint32(), readUint32(), readUint32());
-              break;
-            }
-            case 7: { // ABSOLUTE_16 — payload width depends on mode
-              if (!requireBytes(use32BitPayload ? 4 : 2)) break;
-              extendCurrentEdge(readIdx());
-              advanceEdgePointer(2);
-              break;
-            }
-            case 8: { // ABSOLUTE_32 — always 32-bit
-              if (!requireBytes(4)) break;
-              extendCurrentEdge(readUint32());
-              advanceEdgePointer(2);
-              break;
-            }
-            case 9: { // REMOVE
-              removeCurrentEdge();
-              break;
-            }
-            case 10: { // INCREASE_VERTEX_LIST_POINTER
-              globalVertexPtr++;
-              break;
-            }
-            default:
-              break;
-          }
-        }
+      auto requireBytes = [&](size_t n) -> bool {
+        return offset + n <= rawData.size();
+      };
 
-        return triangles;
-      }; // end decode lambda
+      auto readUint16 = [&]() -> VertexIndex {
+        uint16_t v = 0;
+        std::memcpy(&v, &rawData[offset], sizeof(v));
+        offset += sizeof(v);
+        return static_cast<VertexIndex>(v);
+      };
 
-      // ── mode detection: try 16-bit, fall back to 32-bit (mirrors hpsdecode) ──
+      auto readUint32 = [&]() -> VertexIndex {
+        uint32_t v = 0;
+        std::memcpy(&v, &rawData[offset], sizeof(v));
+        offset += sizeof(v);
+        return static_cast<VertexIndex>(v);
+      };
 
-      auto result = decode(false);
-      if (result.size() == expectedFaceCount)
-        return result;
+      // Read one index according to the current payload mode
+      auto readIdx = [&]() -> VertexIndex {
+        return use32BitPayload ? readUint32() : readUint16();
+      };
 
-      auto result32 = decode(true);
-      if (result32.size() == expectedFaceCount)
-        return result32;
+      auto advanceEdgePointer = [&](size_t n = 1) {
+        if (edgeRing.Empty())
+          return;
+        for (; n > 0; --n)
+          currentEdge = edgeRing.Next(currentEdge);
+      };
 
-      // Neither mode matched — return whichever is closer and warn
-      std::cerr << "Warning: Face count mismatch — expected " << expectedFaceCount
-                << ", got " << result32.size() << " (32-bit) or " << result.size() << " (16-bit)"
-                << std::endl;
-      return result32;
-    }
+      auto createRestartFace = [&](VertexIndex v0, VertexIndex v1, VertexIndex v2) {
+        triangles.push_back({v0, v1, v2});
+        currentEdge = edgeRing.Reset({v0, v1}, {v1, v2}, {v2, v0});
+      };
 
-    std::vector<Open3SDCM::Triangle> ParseFacets(Poco::AutoPtr<Poco::XML::NodeList> BinaryNodes, const std::string& schema, const std::map<std::string, std::string>& props)
-    {
-      try
-      {
-        if (!BinaryNodes.isNull() && BinaryNodes->length() > 0)
-        {
-          auto binaryElement = dynamic_cast<Poco::XML::Element*>(BinaryNodes->item(0));
-          if (binaryElement)
-          {
-            // Get the CA element inside Binary_data
+      // curr -> (curr.start, v), (v, curr.end); the pointer stays on the first
+      auto extendCurrentEdge = [&](VertexIndex v) {
+        if (edgeRing.Empty())
+          return;
+        const Edge curr = edgeRing[currentEdge];
+        triangles.push_back({v, curr.end, curr.start});
+        edgeRing[currentEdge].end = v;
+        edgeRing.InsertAfter(currentEdge, Edge{v, curr.end});
+      };
 
-            Poco::AutoPtr<Poco::XML::NodeList> caNodes = binaryElement->getElementsByTagName("Facets");
-            if (caNodes->length() > 0)
-            {
-              auto caElement = dynamic_cast<Poco::XML::Element*>(caNodes->item(0));
-              std::string base64Text = caElement->innerText();
-              auto BufferSize = GetBufferSize(BinaryNodes, "Facets");
-              auto FaceCount = GetElemCount(BinaryNodes, "Facets");
-              auto rawData = DecodeBuffer(base64Text, BufferSize);
+      // prev, curr -> (prev.start, curr.end); the pointer moves past the new edge
+      auto handlePrevious = [&]() {
+        if (edgeRing.Size() < 2)
+          return;
+        const EdgeRing::NodeId prevNode = edgeRing.Prev(currentEdge);
+        const Edge prevEdge = edgeRing[prevNode];
+        const Edge currEdge = edgeRing[currentEdge];
+        triangles.push_back({currEdge.start, prevEdge.start, currEdge.end});
+
+        edgeRing[prevNode] = {prevEdge.start, currEdge.end};
+        edgeRing.Remove(currentEdge);
+        currentEdge = edgeRing.Next(prevNode);
+      };
 
-              // Facets don't seem to be encrypted in CE schema based on Python implementation
-              // But if they were, we would do:
-              // rawData = DecryptBuffer(rawData, schema, props);
+      // curr, next -> (curr.start, next.end); the pointer moves past the new edge
+      auto handleNext = [&]() {
+        if (edgeRing.Size() < 2)
+          return;
+        const EdgeRing::NodeId nextNode = edgeRing.Next(currentEdge);
+        const Edge currEdge = edgeRing[currentEdge];
+        const Edge nextEdge = edgeRing[nextNode];
+        triangles.push_back({currEdge.start, nextEdge.end, currEdge.end});
+
+        edgeRing[currentEdge] = {currEdge.start, nextEdge.end};
+        edgeRing.Remove(nextNode);
+        currentEdge = edgeRing.Next(currentEdge);
+      };
 
-              return InterpretFacetsBuffer(rawData, FaceCount);
-            }
-          }
+      auto removeCurrentEdge = [&]() {
+        if (edgeRing.Empty())
+          return;
+        const EdgeRing::NodeId prevNode = edgeRing.Prev(currentEdge);
+        const EdgeRing::NodeId nextNode = edgeRing.Next(currentEdge);
+        const Edge prevEdge = edgeRing[prevNode];
+        const Edge currEdge = edgeRing[currentEdge];
+
+        if (prevEdge.start == currEdge.end && edgeRing.Size() > 2) {
+          // Drop the spike prev/curr and reconnect its neighbours
+          const EdgeRing::NodeId beforeNode = edgeRing.Prev(prevNode);
+          edgeRing.Remove(prevNode);
+          edgeRing.Remove(currentEdge);
+          edgeRing[beforeNode].end = edgeRing[nextNode].start;
+          currentEdge = nextNode;
+        } else {
+          edgeRing[prevNode].end = currEdge.end;
+          edgeRing.Remove(currentEdge);
+          currentEdge = edgeRing.Empty() ? EdgeRing::kNoNode : nextNode;
         }
-        return {};
-      }
-      catch (const Poco::Exception& ex)
-      {
+      };
 
-        return {};
-      }
-    }
-    std::optional<Open3SDCM::ColorRGB> ParseFacetBaseColor(Poco::AutoPtr<Poco::XML::NodeList> BinaryNodes)
-    {
-      try
-      {
-        if (!BinaryNodes.isNull() && BinaryNodes->length() > 0)
-        {
-          auto binaryElement = dynamic_cast<Poco::XML::Element*>(BinaryNodes->item(0));
-          if (binaryElement)
-          {
-            Poco::AutoPtr<Poco::XML::NodeList> facetNodes = binaryElement->getElementsByTagName("Facets");
-            if (facetNodes->length() > 0)
-            {
-              auto facetsElement = dynamic_cast<Poco::XML::Element*>(facetNodes->item(0));
-              if (facetsElement != nullptr)
-              {
-                const auto colorValue = GetOptionalAttribute(*facetsElement, "color");
-                if (colorValue.has_value())
-                {
-                  const auto packedColor = ParseUint32(*colorValue);
-                  if (packedColor.has_value())
-                  {
-                    return DecodePackedColor(*packedColor);
-                  }
-                }
-              }
-            }
+      // ── main decode loop ─────────────────────────────────────────────────
+
+      while (offset < rawData.size()) {
+        // Early-abort when clearly in the wrong mode
+        if (IsRunaway(expectedFaceCount, triangles.size(), edgeRing.Size()))
+          break;
+
+        const uint8_t opcode = static_cast<uint8_t>(rawData[offset]) & 0x0F;
+        offset++;
+
+        switch (opcode) {
+          case 0: { // VERTEX_LIST
+            extendCurrentEdge(globalVertexPtr++);
+            advanceEdgePointer(2);
+            break;
+          }
+          case 1: { // PREVIOUS
+            handlePrevious();
+            break;
+          }
+          case 2: { // NEXT
+            handleNext();
+            break;
+          }
+          case 3: { // IGNORE
+            advanceEdgePointer(1);
+            break;
+          }
+          case 4: { // RESTART
+            const VertexIndex v0 = globalVertexPtr++;
+            const VertexIndex v1 = globalVertexPtr++;
+            const VertexIndex v2 = globalVertexPtr++;
+            createRestartFace(v0, v1, v2);
+            break;
+          }
+          case 5: { // RESTART_16 — payload width depends on mode
+            if (!requireBytes(use32BitPayload ? 12 : 6)) break;
+            createRestartFace(readIdx(), readIdx(), readIdx());
+            break;
           }
+          case 6: { // RESTART_32 — always 32-bit
+            if (!requireBytes(12)) break;
+            createRestartFace(readUint32(), readUint32(), readUint32());
+            break;
+          }
+          case 7: { // ABSOLUTE_16 — payload width depends on mode
+            if (!requireBytes(use32BitPayload ? 4 : 2)) break;
+            extendCurrentEdge(readIdx());
+            advanceEdgePointer(2);
+            break;
+          }
+          case 8: { // ABSOLUTE_32 — always 32-bit
+            if (!requireBytes(4)) break;
+            extendCurrentEdge(readUint32());
+            advanceEdgePointer(2);
+            break;
+          }
+          case 9: { // REMOVE
+            removeCurrentEdge();
+            break;
+          }
+          case 10: { // INCREASE_VERTEX_LIST_POINTER
+            globalVertexPtr++;
+            break;
+          }
+          default:
+            break;
         }
       }
-      catch (const Poco::Exception&)
-      {
-      }
-
-      return std::nullopt;
     }
 
-    std::optional<Open3SDCM::TextureCoordinate> DecodePackedTextureCoordinate(const std::uint32_t packedTextureCoordinate)
+    struct FacetPrescan
+    {
+      std::size_t faceCount{0};
+      bool widthDependent{false};// saw an opcode 5 or 7
+    };
+
+    // Walks the opcodes for one payload width without building the boundary or
+    // the faces. Only the boundary size is tracked, to apply the same guards as
+    // DecodeFacets; a REMOVE is counted as dropping one edge (the two-edge case
+    // depends on vertex indices), so the face count is an estimate there.
+    FacetPrescan PrescanFacets(const std::vector<char>& rawData, const size_t expectedFaceCount, const bool use32BitPayload)
+    {
+      FacetPrescan prescan;
+      const std::size_t indexSize = use32BitPayload ? 4 : 2;
+      std::size_t boundarySize = 0;
+      std::size_t offset = 0;
+
+      while (offset < rawData.size())
+      {
+        if (IsRunaway(expectedFaceCount, prescan.faceCount, boundarySize))
+          break;
+
+        const uint8_t opcode = static_cast<uint8_t>(rawData[offset]) & 0x0F;
+        offset++;
+        const std::size_t remaining = rawData.size() - offset;
+
+        switch (opcode) {
+          case 0:// VERTEX_LIST
+            if (boundarySize > 0) { prescan.faceCount++; boundarySize++; }
+            break;
+          case 1:// PREVIOUS
+          case 2:// NEXT
+            if (boundarySize >= 2) { prescan.faceCount++; boundarySize--; }
+            break;
+          case 4:// RESTART
+            prescan.faceCount++;
+            boundarySize = 3;
+            break;
+          case 5:// RESTART_16
+            prescan.widthDependent = true;
+            if (remaining < 3 * indexSize) break;
+            offset += 3 * indexSize;
+            prescan.faceCount++;
+            boundarySize = 3;
+            break;
+          case 6:// RESTART_32
+            if (remaining < 12) break;
+            offset += 12;
+            prescan.faceCount++;
+            boundarySize = 3;
+            break;
+          case 7:// ABSOLUTE_16
+            prescan.widthDependent = true;
+            if (remaining < indexSize) break;
+            offset += indexSize;
+            if (boundarySize > 0) { prescan.faceCount++; boundarySize++; }
+            break;
+          case 8:// ABSOLUTE_32
+            if (remaining < 4) break;
+            offset += 4;
+            if (boundarySize > 0) { prescan.faceCount++; boundarySize++; }
+            break;
+          case 9:// REMOVE
+            if (boundarySize > 0) boundarySize--;
+            break;
+          default:
+            break;
+        }
+      }
+
+      return prescan;
+    }
+
+    // Buffers of the facet decode that a DCMParser keeps from one file to the next
+    struct FacetScratch
+    {
+      std::vector<char> payload;
+      EdgeRing edgeRing;
+      std::vector<Open3SDCM::Triangle> otherTriangles;// decode of the width not picked
+    };
+
+    // Picks the payload width from cheap opcode walks, then decodes once into
+    // `triangles`. The other width is only decoded as well when the pick does
+    // not decode to facet_count (corrupt data, or an inexact prescan estimate).
+    void InterpretFacetsBufferInto(const std::vector<char>& rawData,
+                                   size_t expectedFaceCount,
+                                   Open3SDCM::FacetDecodeInfo& info,
+                                   FacetScratch& scratch,
+                                   std::vector<Open3SDCM::Triangle>& triangles)
+    {
+      using Open3SDCM::FacetIndexWidth;
+      using Open3SDCM::FacetWidthReason;
+
+      const StageTimer timer(ParseStage::FacetDecode, rawData.size());
+      info = {};
+      info.expectedFaceCount = expectedFaceCount;
+
+      const FacetPrescan prescan16 = PrescanFacets(rawData, expectedFaceCount, false);
+      info.prescanFaceCount16 = prescan16.faceCount;
+
+      bool use32Bit = false;
+      if (!prescan16.widthDependent)
+      {
+        // Both widths walk the exact same opcodes
+        info.prescanFaceCount32 = prescan16.faceCount;
+        info.reason = FacetWidthReason::WidthIndependent;
+      }
+      else
+      {
+        const FacetPrescan prescan32 = PrescanFacets(rawData, expectedFaceCount, true);
+        info.prescanFaceCount32 = prescan32.faceCount;
+
+        const bool match16 = prescan16.faceCount == expectedFaceCount;
+        const bool match32 = prescan32.faceCount == expectedFaceCount;
+        if (match16 && match32)
+        {
+          info.reason = FacetWidthReason::BothMatch;
+        }
+        else if (match16 || match32)
+        {
+          use32Bit = match32;
+          info.reason = FacetWidthReason::FaceCountMatch;
+        }
+        else
+        {
+          // Neither width matches: keep the 32-bit decode, like hpsdecode
+          use32Bit = true;
+          info.reason = FacetWidthReason::NoWidthMatches;
+        }
+      }
+
+      DecodeFacets(rawData, expectedFaceCount, use32Bit, scratch.edgeRing, triangles);
+      info.decodePasses = 1;
+
+      // The prescan estimate can be off after two-edge REMOVEs; confirm with the other width
+      if (triangles.size() != expectedFaceCount && prescan16.widthDependent)
+      {
+        auto& otherTriangles = scratch.otherTriangles;
+        DecodeFacets(rawData, expectedFaceCount, !use32Bit, scratch.edgeRing, otherTriangles);
+        info.decodePasses = 2;
+        const bool otherMatches = otherTriangles.size() == expectedFaceCount;
+        info.reason = otherMatches ? FacetWidthReason::PrescanMismatch : FacetWidthReason::NoWidthMatches;
+        if (otherMatches || !use32Bit)
+        {
+          use32Bit = !use32Bit;
+          triangles.swap(otherTriangles);
+        }
+      }
+
+      info.width = use32Bit ? FacetIndexWidth::Bits32 : FacetIndexWidth::Bits16;
+      info.decodedFaceCount = triangles.size();
+
+      if (triangles.size() != expectedFaceCount)
+      {
+        O3SDCM_LOG_WARN("Face count mismatch — expected {}, got {} ({})", expectedFaceCount, triangles.size(), use32Bit ? "32-bit" : "16-bit");
+      }
+    }
+
+    std::vector<Open3SDCM::Triangle> InterpretFacetsBuffer(const std::vector<char>& rawData,
+                                                           size_t expectedFaceCount,
+                                                           Open3SDCM::FacetDecodeInfo& info)
+    {
+      FacetScratch scratch;
+      std::vector<Open3SDCM::Triangle> triangles;
+      InterpretFacetsBufferInto(rawData, expectedFaceCount, info, scratch, triangles);
+      return triangles;
+    }
+
+    // Decodes <Facets> into `triangles`, left empty when there are none or they are unreadable
+    void ParseFacets(const std::optional<DcmElement>& FacetsElement,
+                     std::string_view schema,
+                     const PropertyMap& props,
+                     Open3SDCM::FacetDecodeInfo& decodeInfo,
+                     FacetScratch& scratch,
+                     std::vector<Open3SDCM::Triangle>& triangles)
+    {
+      triangles.clear();
+      try
+      {
+        if (FacetsElement.has_value())
+        {
+          auto FaceCount = GetElemCount(FacetsElement, "Facets");
+          DecodePayloadBuffer(FacetsElement->InnerText(), scratch.payload);
+
+          // Facets don't seem to be encrypted in CE schema based on Python implementation
+          // But if they were, we would do:
+          // rawData = DecryptBuffer(rawData, schema, props);
+
+          InterpretFacetsBufferInto(scratch.payload, FaceCount, decodeInfo, scratch, triangles);
+        }
+      }
+      catch (const Poco::Exception& ex)
+      {
+        triangles.clear();
+      }
+    }
+    std::optional<Open3SDCM::ColorRGB> ParseFacetBaseColor(const std::optional<DcmElement>& FacetsElement)
+    {
+      if (FacetsElement.has_value())
+      {
+        const auto colorValue = GetOptionalAttributeView(*FacetsElement, "color");
+        if (colorValue.has_value())
+        {
+          const auto packedColor = ParseUint32(*colorValue);
+          if (packedColor.has_value())
+          {
+            return DecodePackedColor(*packedColor);
+          }
+        }
+      }
+
+      return std::nullopt;
+    }
+
+    std::optional<Open3SDCM::TextureCoordinate> DecodePackedTextureCoordinate(const std::uint32_t packedTextureCoordinate)
     {
       if (packedTextureCoordinate == 0xFFFFFFFFU)
       {
@@ -750,34 +985,82 @@ namespace Open3SDCM
       };
     }
 
-    std::vector<std::vector<std::size_t>> BuildVertexCornerMap(const std::vector<Open3SDCM::Triangle>& triangles,
-                                                               const std::size_t vertexCount)
+    // Corners of each vertex in face order, as one flat table: the corners of
+    // vertex v are corners[offsets[v]] .. corners[offsets[v + 1]]
+    struct VertexCornerMap
+    {
+      std::vector<std::size_t> offsets;
+      std::vector<std::size_t> corners;
+
+      [[nodiscard]] std::size_t Degree(const std::size_t vertexIndex) const
+      {
+        return offsets[vertexIndex + 1] - offsets[vertexIndex];
+      }
+      [[nodiscard]] const std::size_t* Corners(const std::size_t vertexIndex) const { return corners.data() + offsets[vertexIndex]; }
+    };
+
+    void BuildVertexCornerMap(const std::vector<Open3SDCM::Triangle>& triangles,
+                              const std::size_t vertexCount,
+                              VertexCornerMap& cornerMap)
     {
-      std::vector<std::vector<std::size_t>> cornersByVertex(vertexCount);
+      const StageTimer timer(ParseStage::UvDecode);
+      auto& offsets = cornerMap.offsets;
+      auto& corners = cornerMap.corners;
+
+      // Count the corners of each vertex, turn the counts into start offsets, then
+      // place the corners; faces are visited in order both times
+      offsets.clear();
+      ReserveRecycled(offsets, vertexCount + 1);
+      offsets.resize(vertexCount + 1, 0);
+      std::size_t cornerCount = 0;
+      for (const auto& triangle : triangles)
+      {
+        for (const std::size_t vertexIndex : {triangle.v1, triangle.v2, triangle.v3})
+        {
+          if (vertexIndex < vertexCount)
+          {
+            ++offsets[vertexIndex + 1];
+            ++cornerCount;
+          }
+        }
+      }
+      for (std::size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+      {
+        offsets[vertexIndex + 1] += offsets[vertexIndex];
+      }
+
+      ResizeRecycled(corners, cornerCount);
       for (std::size_t faceIndex = 0; faceIndex < triangles.size(); ++faceIndex)
       {
         const std::array<std::size_t, 3> faceVertices = {triangles[faceIndex].v1, triangles[faceIndex].v2, triangles[faceIndex].v3};
         for (std::size_t cornerIndex = 0; cornerIndex < faceVertices.size(); ++cornerIndex)
         {
           const auto vertexIndex = faceVertices[cornerIndex];
-          if (vertexIndex >= vertexCount)
+          if (vertexIndex < vertexCount)
           {
-            continue;
+            // offsets[v] runs ahead as v's corners are placed, ending at the start of v + 1
+            corners[offsets[vertexIndex]++] = faceIndex * 3 + cornerIndex;
           }
-          cornersByVertex[vertexIndex].push_back(faceIndex * 3 + cornerIndex);
         }
       }
-
-      return cornersByVertex;
+      for (std::size_t vertexIndex = vertexCount; vertexIndex > 0; --vertexIndex)
+      {
+        offsets[vertexIndex] = offsets[vertexIndex - 1];
+      }
+      offsets[0] = 0;
     }
 
-    std::vector<std::optional<Open3SDCM::TextureCoordinate>> DecodePerVertexTextureCoordinates(
-      const std::vector<char>& decryptedBytes,
-      const std::size_t vertexCount,
-      const std::vector<Open3SDCM::Triangle>& triangles)
+    // UV stream to one optional coordinate per triangle corner, into `cornerCoordinates`
+    // (left empty on a malformed stream). `cornerMap` is BuildVertexCornerMap of the facets.
+    void DecodePerVertexTextureCoordinatesInto(const std::vector<char>& decryptedBytes,
+                                               const std::size_t vertexCount,
+                                               const std::size_t triangleCount,
+                                               const VertexCornerMap& cornerMap,
+                                               std::vector<std::optional<Open3SDCM::TextureCoordinate>>& cornerCoordinates)
     {
-      const auto cornersByVertex = BuildVertexCornerMap(triangles, vertexCount);
-      std::vector<std::optional<Open3SDCM::TextureCoordinate>> cornerCoordinates(triangles.size() * 3);
+      const StageTimer timer(ParseStage::UvDecode, decryptedBytes.size());
+      cornerCoordinates.clear();
+      ResizeRecycled(cornerCoordinates, triangleCount * 3);
 
       std::size_t offset = 0;
       const auto readByte = [&](std::uint8_t& value) -> bool
@@ -813,18 +1096,20 @@ namespace Open3SDCM
         std::uint8_t flag = 0;
         if (!readByte(flag))
         {
-          std::cerr << "Error: Unexpected end of UV stream while reading vertex flag" << std::endl;
-          return {};
+          O3SDCM_LOG_ERROR("Unexpected end of UV stream while reading vertex flag");
+          cornerCoordinates.clear();
+          return;
         }
 
-        const auto& vertexCorners = cornersByVertex[vertexIndex];
-        const std::size_t degree = vertexCorners.size();
+        const std::size_t* vertexCorners = cornerMap.Corners(vertexIndex);
+        const std::size_t degree = cornerMap.Degree(vertexIndex);
         if (flag == 0)
         {
           if (degree != 0)
           {
-            std::cerr << "Error: Invalid UV stream, vertex degree mismatch" << std::endl;
-            return {};
+            O3SDCM_LOG_ERROR("Invalid UV stream, vertex degree mismatch");
+            cornerCoordinates.clear();
+            return;
           }
           continue;
         }
@@ -840,169 +1125,338 @@ namespace Open3SDCM
         }
         else
         {
-          std::cerr << "Error: Invalid UV stream, flag " << static_cast<unsigned int>(flag)
-                    << " does not match vertex degree " << degree << std::endl;
-          return {};
+          O3SDCM_LOG_ERROR("Invalid UV stream, flag {} does not match vertex degree {}", static_cast<unsigned int>(flag), degree);
+          cornerCoordinates.clear();
+          return;
         }
 
-        std::vector<std::optional<Open3SDCM::TextureCoordinate>> decodedCoordinates;
-        decodedCoordinates.reserve(uvCount);
+        // A shared coordinate (flag 1) goes to every corner, otherwise one per corner in face order
         for (std::size_t uvIndex = 0; uvIndex < uvCount; ++uvIndex)
         {
           std::uint32_t packedTextureCoordinate = 0;
           if (!readUint32LE(packedTextureCoordinate))
           {
-            std::cerr << "Error: Unexpected end of UV stream while reading packed coordinate" << std::endl;
-            return {};
+            O3SDCM_LOG_ERROR("Unexpected end of UV stream while reading packed coordinate");
+            cornerCoordinates.clear();
+            return;
+          }
+          const auto coordinate = DecodePackedTextureCoordinate(packedTextureCoordinate);
+          if (flag == 1)
+          {
+            for (std::size_t cornerOrdinal = 0; cornerOrdinal < degree; ++cornerOrdinal)
+            {
+              cornerCoordinates[vertexCorners[cornerOrdinal]] = coordinate;
+            }
+          }
+          else
+          {
+            cornerCoordinates[vertexCorners[uvIndex]] = coordinate;
           }
-          decodedCoordinates.push_back(DecodePackedTextureCoordinate(packedTextureCoordinate));
         }
+      }
+    }
 
-        if (degree == 0)
-        {
-          continue;
-        }
+    std::vector<std::optional<Open3SDCM::TextureCoordinate>> DecodePerVertexTextureCoordinates(
+      const std::vector<char>& decryptedBytes,
+      const std::size_t vertexCount,
+      const std::vector<Open3SDCM::Triangle>& triangles)
+    {
+      VertexCornerMap cornerMap;
+      BuildVertexCornerMap(triangles, vertexCount, cornerMap);
+      std::vector<std::optional<Open3SDCM::TextureCoordinate>> cornerCoordinates;
+      DecodePerVertexTextureCoordinatesInto(decryptedBytes, vertexCount, triangles.size(), cornerMap, cornerCoordinates);
+      return cornerCoordinates;
+    }
 
-        if (flag == 1)
+    // Reads the metadata of one <PerVertexTextureCoord> and decodes its decrypted UV
+    // stream into `stream`; mapping the stream to triangle corners needs the facets
+    void ReadTextureCoordinateStreamInto(const DcmElement& textureCoordElement,
+                                         std::string_view schema,
+                                         const PropertyMap& properties,
+                                         Open3SDCM::TextureCoordinateData& textureCoordinate,
+                                         std::vector<char>& stream)
+    {
+      textureCoordinate.textureCoordId = GetOptionalAttribute(textureCoordElement, "TextureCoordId");
+      textureCoordinate.textureId = GetOptionalAttribute(textureCoordElement, "TextureId");
+      textureCoordinate.key = GetOptionalAttribute(textureCoordElement, "Key");
+      if (const auto encodedByteCount = GetOptionalSizeTAttribute(textureCoordElement, "Base64EncodedBytes"))
+      {
+        textureCoordinate.encodedByteCount = *encodedByteCount;
+      }
+
+      DecodePayloadBuffer(textureCoordElement.InnerText(), stream);
+      stream = DecryptBuffer(std::move(stream),
+                             schema,
+                             properties,
+                             textureCoordinate.key.has_value(),
+                             textureCoordinate.encodedByteCount);
+    }
+
+    std::vector<char> ReadTextureCoordinateStream(const DcmElement& textureCoordElement,
+                                                  std::string_view schema,
+                                                  const PropertyMap& properties,
+                                                  Open3SDCM::TextureCoordinateData& textureCoordinate)
+    {
+      std::vector<char> stream;
+      ReadTextureCoordinateStreamInto(textureCoordElement, schema, properties, textureCoordinate, stream);
+      return stream;
+    }
+
+    void ParseTextureImageInto(const DcmElement& textureImageElement, Open3SDCM::EmbeddedTextureImage& textureImage)
+    {
+      textureImage.version = GetOptionalAttribute(textureImageElement, "Version");
+      textureImage.textureName = GetOptionalAttribute(textureImageElement, "TextureName");
+      textureImage.id = GetOptionalAttribute(textureImageElement, "Id");
+      textureImage.textureId = GetOptionalAttribute(textureImageElement, "TextureId");
+      textureImage.refTextureCoordId = GetOptionalAttribute(textureImageElement, "RefTextureCoordId");
+      textureImage.textureCoordSet = GetOptionalAttribute(textureImageElement, "TextureCoordSet");
+      textureImage.mimeType = std::string("image/jpeg");
+
+      if (const auto width = GetOptionalSizeTAttribute(textureImageElement, "Width"))
+      {
+        textureImage.width = *width;
+      }
+      if (const auto height = GetOptionalSizeTAttribute(textureImageElement, "Height"))
+      {
+        textureImage.height = *height;
+      }
+      if (const auto bytesPerPixel = GetOptionalSizeTAttribute(textureImageElement, "BytesPerPixel"))
+      {
+        textureImage.bytesPerPixel = *bytesPerPixel;
+      }
+      if (const auto encodedByteCount = GetOptionalSizeTAttribute(textureImageElement, "Base64EncodedBytes"))
+      {
+        textureImage.encodedByteCount = *encodedByteCount;
+      }
+
+      StageTimer timer(ParseStage::TextureDecode);
+      DecodeBufferInto(textureImageElement.InnerText(), textureImage.imageBytes);
+      timer.AddBytes(textureImage.imageBytes.size());
+    }
+
+    // Buffers a DCMParser keeps from one file to the next, so that a run of similar
+    // files decodes without growing (allocating) any of them again
+    struct ParseScratch
+    {
+      ParseArena arena;// the scanned document, rewound at the start of each parse
+      FacetScratch facets;
+      VertexCornerMap cornerMap;
+      std::vector<std::vector<char>> uvStreams;// one per texture coordinate set
+      // Output buffers of the previous result, handed to the next one
+      std::vector<std::vector<std::optional<Open3SDCM::TextureCoordinate>>> cornerBuffers;
+      std::vector<std::vector<std::uint8_t>> imageBuffers;
+
+      // Moves the large buffers of `surfaceData` into the pools and empties it
+      void Recycle(Open3SDCM::SurfaceData& surfaceData)
+      {
+        for (auto& textureCoordinate : surfaceData.textureCoordinates)
         {
-          for (const auto cornerIndex : vertexCorners)
+          if (textureCoordinate.cornerCoordinates.capacity() > 0)
           {
-            cornerCoordinates[cornerIndex] = decodedCoordinates.front();
+            textureCoordinate.cornerCoordinates.clear();
+            cornerBuffers.push_back(std::move(textureCoordinate.cornerCoordinates));
           }
-          continue;
         }
-
-        for (std::size_t cornerOrdinal = 0; cornerOrdinal < degree; ++cornerOrdinal)
+        for (auto& textureImage : surfaceData.textureImages)
         {
-          cornerCoordinates[vertexCorners[cornerOrdinal]] = decodedCoordinates[cornerOrdinal];
+          if (textureImage.imageBytes.capacity() > 0)
+          {
+            textureImage.imageBytes.clear();
+            imageBuffers.push_back(std::move(textureImage.imageBytes));
+          }
         }
+        surfaceData = {};
       }
 
-      return cornerCoordinates;
-    }
+      // Gives `textureCoordinate` and `textureImage` pooled buffers
+      void Lend(Open3SDCM::TextureCoordinateData& textureCoordinate) { LendFrom(cornerBuffers, textureCoordinate.cornerCoordinates); }
+      void Lend(Open3SDCM::EmbeddedTextureImage& textureImage) { LendFrom(imageBuffers, textureImage.imageBytes); }
 
-    void ParseTextureCoordinateMetadata(Poco::XML::Element* textureDataElement,
-                                        const std::string& schema,
-                                        const std::map<std::string, std::string>& properties,
-                                        const std::size_t vertexCount,
-                                        const std::vector<Open3SDCM::Triangle>& triangles,
-                                        Open3SDCM::SurfaceData& surfaceData)
-    {
-      if (textureDataElement == nullptr)
+      // Sizes a stream slot per texture coordinate set, keeping the slots from before
+      std::vector<std::vector<char>>& UvStreams(const std::size_t count)
       {
-        return;
+        if (uvStreams.size() < count)
+        {
+          uvStreams.resize(count);
+        }
+        return uvStreams;
       }
 
-      for (auto child = textureDataElement->firstChild(); child != nullptr; child = child->nextSibling())
+      [[nodiscard]] std::size_t RetainedBytes() const
       {
-        auto textureCoordElement = dynamic_cast<Poco::XML::Element*>(child);
-        if (textureCoordElement == nullptr || textureCoordElement->tagName() != "PerVertexTextureCoord")
+        std::size_t bytes = arena.CapacityBytes() + facets.payload.capacity() + facets.edgeRing.CapacityBytes() +
+                            facets.otherTriangles.capacity() * sizeof(Open3SDCM::Triangle) +
+                            (cornerMap.offsets.capacity() + cornerMap.corners.capacity()) * sizeof(std::size_t);
+        for (const auto& stream : uvStreams)
         {
-          continue;
+          bytes += stream.capacity();
         }
-
-        Open3SDCM::TextureCoordinateData textureCoordinate;
-        textureCoordinate.textureCoordId = GetOptionalAttribute(*textureCoordElement, "TextureCoordId");
-        textureCoordinate.textureId = GetOptionalAttribute(*textureCoordElement, "TextureId");
-        textureCoordinate.key = GetOptionalAttribute(*textureCoordElement, "Key");
-        if (const auto encodedByteCount = GetOptionalSizeTAttribute(*textureCoordElement, "Base64EncodedBytes"))
+        for (const auto& buffer : cornerBuffers)
         {
-          textureCoordinate.encodedByteCount = *encodedByteCount;
+          bytes += buffer.capacity() * sizeof(buffer[0]);
         }
-
-        std::string base64Text = textureCoordElement->innerText();
-        const std::size_t estimatedBufferSize = textureCoordinate.encodedByteCount > 0
-          ? textureCoordinate.encodedByteCount
-          : base64Text.size();
-        auto rawData = DecodeBuffer(base64Text, estimatedBufferSize);
-        rawData = DecryptBuffer(std::move(rawData),
-                                schema,
-                                properties,
-                                textureCoordinate.key.has_value(),
-                                textureCoordinate.encodedByteCount);
-        textureCoordinate.cornerCoordinates = DecodePerVertexTextureCoordinates(rawData, vertexCount, triangles);
-
-        surfaceData.textureCoordinates.push_back(std::move(textureCoordinate));
+        for (const auto& buffer : imageBuffers)
+        {
+          bytes += buffer.capacity();
+        }
+        return bytes;
       }
-    }
 
-    void ParseTextureImages(Poco::XML::Element* textureImagesElement, Open3SDCM::SurfaceData& surfaceData)
-    {
-      if (textureImagesElement == nullptr)
+      // Frees the largest buffers until at most `budget` bytes remain. The buffers of an
+      // emptied result, when given, compete with the scratch ones.
+      void Trim(const std::size_t budget,
+                std::vector<float>* vertices = nullptr,
+                std::vector<Open3SDCM::Triangle>* triangles = nullptr)
       {
-        return;
+        std::size_t retained = RetainedBytes();
+        retained += vertices != nullptr ? vertices->capacity() * sizeof(float) : 0;
+        retained += triangles != nullptr ? triangles->capacity() * sizeof(Open3SDCM::Triangle) : 0;
+        while (retained > budget)
+        {
+          const std::size_t released = ReleaseLargest(vertices, triangles);
+          if (released == 0)
+          {
+            break;
+          }
+          retained -= released;
+        }
       }
 
-      for (auto child = textureImagesElement->firstChild(); child != nullptr; child = child->nextSibling())
+    private:
+      template <typename Buffer>
+      static void LendFrom(std::vector<Buffer>& pool, Buffer& buffer)
       {
-        auto textureImageElement = dynamic_cast<Poco::XML::Element*>(child);
-        if (textureImageElement == nullptr || textureImageElement->tagName() != "TextureImage")
+        if (!pool.empty() && buffer.capacity() == 0)
         {
-          continue;
+          buffer = std::move(pool.back());
+          pool.pop_back();
         }
+      }
 
-        Open3SDCM::EmbeddedTextureImage textureImage;
-        textureImage.version = GetOptionalAttribute(*textureImageElement, "Version");
-        textureImage.textureName = GetOptionalAttribute(*textureImageElement, "TextureName");
-        textureImage.id = GetOptionalAttribute(*textureImageElement, "Id");
-        textureImage.textureId = GetOptionalAttribute(*textureImageElement, "TextureId");
-        textureImage.refTextureCoordId = GetOptionalAttribute(*textureImageElement, "RefTextureCoordId");
-        textureImage.textureCoordSet = GetOptionalAttribute(*textureImageElement, "TextureCoordSet");
-        textureImage.mimeType = std::string("image/jpeg");
+      // Frees the largest retained buffer and returns its size in bytes
+      std::size_t ReleaseLargest(std::vector<float>* vertices, std::vector<Open3SDCM::Triangle>* triangles)
+      {
+        std::size_t largest = 0;
+        std::function<void()> release;
+        const auto consider = [&](auto& buffer, const std::size_t bytes)
+        {
+          if (bytes > largest)
+          {
+            largest = bytes;
+            release = [&buffer] { std::remove_reference_t<decltype(buffer)>().swap(buffer); };
+          }
+        };
 
-        if (const auto width = GetOptionalSizeTAttribute(*textureImageElement, "Width"))
+        if (vertices != nullptr)
+        {
+          consider(*vertices, vertices->capacity() * sizeof(float));
+        }
+        if (triangles != nullptr)
+        {
+          consider(*triangles, triangles->capacity() * sizeof(Open3SDCM::Triangle));
+        }
+        consider(facets.payload, facets.payload.capacity());
+        consider(facets.otherTriangles, facets.otherTriangles.capacity() * sizeof(Open3SDCM::Triangle));
+        consider(cornerMap.offsets, cornerMap.offsets.capacity() * sizeof(std::size_t));
+        consider(cornerMap.corners, cornerMap.corners.capacity() * sizeof(std::size_t));
+        for (auto& stream : uvStreams)
+        {
+          consider(stream, stream.capacity());
+        }
+        for (auto& buffer : cornerBuffers)
+        {
+          consider(buffer, buffer.capacity() * sizeof(buffer[0]));
+        }
+        for (auto& buffer : imageBuffers)
         {
-          textureImage.width = *width;
+          consider(buffer, buffer.capacity());
         }
-        if (const auto height = GetOptionalSizeTAttribute(*textureImageElement, "Height"))
+        if (facets.edgeRing.CapacityBytes() > largest)
         {
-          textureImage.height = *height;
+          largest = facets.edgeRing.CapacityBytes();
+          release = [this] { facets.edgeRing.Release(); };
         }
-        if (const auto bytesPerPixel = GetOptionalSizeTAttribute(*textureImageElement, "BytesPerPixel"))
+        if (arena.CapacityBytes() > largest)
         {
-          textureImage.bytesPerPixel = *bytesPerPixel;
+          largest = arena.CapacityBytes();
+          release = [this] { arena.Release(); };
         }
-        if (const auto encodedByteCount = GetOptionalSizeTAttribute(*textureImageElement, "Base64EncodedBytes"))
+
+        if (release)
         {
-          textureImage.encodedByteCount = *encodedByteCount;
+          release();
         }
+        return largest;
+      }
+    };
+
+    void ParseTextureCoordinateMetadata(const std::pmr::vector<DcmElement>& textureCoordElements,
+                                        std::string_view schema,
+                                        const PropertyMap& properties,
+                                        const std::size_t vertexCount,
+                                        const std::vector<Open3SDCM::Triangle>& triangles,
+                                        ParseScratch& scratch,
+                                        Open3SDCM::SurfaceData& surfaceData)
+    {
+      if (textureCoordElements.empty())
+      {
+        return;
+      }
 
-        std::string base64Text = textureImageElement->innerText();
-        const std::size_t estimatedBufferSize = textureImage.encodedByteCount > 0 ? textureImage.encodedByteCount : base64Text.size();
-        auto decodedBytes = DecodeBuffer(base64Text, estimatedBufferSize);
-        textureImage.imageBytes.assign(decodedBytes.begin(), decodedBytes.end());
+      // Every coordinate set maps onto the same facets
+      BuildVertexCornerMap(triangles, vertexCount, scratch.cornerMap);
+      auto& uvStreams = scratch.UvStreams(textureCoordElements.size());
+      surfaceData.textureCoordinates.resize(textureCoordElements.size());
+      for (std::size_t setIndex = 0; setIndex < textureCoordElements.size(); ++setIndex)
+      {
+        auto& textureCoordinate = surfaceData.textureCoordinates[setIndex];
+        scratch.Lend(textureCoordinate);
+        ReadTextureCoordinateStreamInto(textureCoordElements[setIndex], schema, properties, textureCoordinate, uvStreams[setIndex]);
+        DecodePerVertexTextureCoordinatesInto(uvStreams[setIndex], vertexCount, triangles.size(), scratch.cornerMap, textureCoordinate.cornerCoordinates);
+      }
+    }
 
-        surfaceData.textureImages.push_back(std::move(textureImage));
+    void ParseTextureImages(const std::pmr::vector<DcmElement>& textureImageElements, ParseScratch& scratch, Open3SDCM::SurfaceData& surfaceData)
+    {
+      surfaceData.textureImages.resize(textureImageElements.size());
+      for (std::size_t imageIndex = 0; imageIndex < textureImageElements.size(); ++imageIndex)
+      {
+        auto& textureImage = surfaceData.textureImages[imageIndex];
+        scratch.Lend(textureImage);
+        ParseTextureImageInto(textureImageElements[imageIndex], textureImage);
       }
     }
 
-    void ParseSurfaceData(Poco::AutoPtr<Poco::XML::Document> document,
-                          const std::string& schema,
-                          const std::map<std::string, std::string>& properties,
+    void ParseSurfaceData(const DcmDocument& document,
                           const std::size_t vertexCount,
                           const std::vector<Open3SDCM::Triangle>& triangles,
+                          ParseScratch& scratch,
                           Open3SDCM::SurfaceData& surfaceData)
     {
-      if (document.isNull())
-      {
-        return;
-      }
+      // Without <TextureData2> the scan already fell back to the root-level <TextureImages>
+      ParseTextureCoordinateMetadata(document.textureCoordinates, document.schema, document.properties, vertexCount, triangles, scratch, surfaceData);
+      ParseTextureImages(document.textureImages, scratch, surfaceData);
+    }
 
-      auto* rootElement = document->documentElement();
-      if (rootElement == nullptr)
+    void ReportVertexCount(const std::size_t floatCount, const std::size_t expectedVertexCount)
+    {
+      O3SDCM_LOG_DEBUG("{} floats ({} vertices) have been read from buffer", floatCount, floatCount / 3);
+      if (floatCount != expectedVertexCount * 3)
       {
-        return;
+        O3SDCM_LOG_ERROR("Expected to get {} floats but got {}", expectedVertexCount * 3, floatCount);
       }
+    }
 
-      auto* textureDataElement = FindFirstDirectChildElement(rootElement, "TextureData2");
-      if (textureDataElement == nullptr)
+    void ReportFacetCount(const std::size_t faceCount, const std::size_t expectedFaceCount, const Open3SDCM::FacetDecodeInfo& info)
+    {
+      O3SDCM_LOG_DEBUG("{} triangles have been read from buffer ({}-bit indices, {} decode pass(es))",
+                       faceCount,
+                       info.width == Open3SDCM::FacetIndexWidth::Bits32 ? 32 : 16,
+                       info.decodePasses);
+      if (faceCount != expectedFaceCount)
       {
-        ParseTextureImages(FindFirstDirectChildElement(rootElement, "TextureImages"), surfaceData);
-        return;
+        O3SDCM_LOG_ERROR("Expected to get {} faces but got {}", expectedFaceCount, faceCount);
       }
-
-      ParseTextureCoordinateMetadata(textureDataElement, schema, properties, vertexCount, triangles, surfaceData);
-      ParseTextureImages(FindFirstDirectChildElement(textureDataElement, "TextureImages"), surfaceData);
     }
 
     bool EnsureParentDirectoryExists(const fs::path& outputPath)
@@ -1128,65 +1582,483 @@ namespace Open3SDCM
       return output.good();
     }
 
-    bool ExportPly(const fs::path& outputPath,
-                   const std::vector<float>& vertices,
-                   const std::vector<Open3SDCM::Triangle>& triangles,
-                   const Open3SDCM::SurfaceData& surfaceData)
+    Open3SDCM::TextureCoordinate ToExportedTextureCoordinate(const std::optional<Open3SDCM::TextureCoordinate>& cornerCoordinate)
     {
-      if (!EnsureParentDirectoryExists(outputPath))
+      const auto resolvedCoordinate = cornerCoordinate.value_or(Open3SDCM::TextureCoordinate{});
+      // The decoded CE texture coordinates use the image's top-left origin,
+      // while OBJ and PLY consumers expect V to be measured from the bottom edge.
+      const float exportedV = cornerCoordinate.has_value() ? 1.0F - resolvedCoordinate.v : resolvedCoordinate.v;
+      return {resolvedCoordinate.u, exportedV};
+    }
+
+    // Buffers small records into large writes; bulk spans bypass the buffer
+    class BinaryChunkWriter
+    {
+    public:
+      static constexpr std::size_t kChunkSize = 1U << 20U;
+
+      explicit BinaryChunkWriter(std::ofstream& output)
+        : m_Output(output)
       {
-        return false;
+        m_Buffer.reserve(kChunkSize);
       }
 
-      std::ofstream output(outputPath);
-      if (!output)
+      // Returns `size` bytes of buffer space to fill, flushing first if needed
+      std::uint8_t* Append(const std::size_t size)
       {
-        return false;
+        if (m_Buffer.size() + size > kChunkSize)
+        {
+          Flush();
+        }
+        const std::size_t offset = m_Buffer.size();
+        m_Buffer.resize(offset + size);
+        return m_Buffer.data() + offset;
       }
 
-      const bool hasColor = surfaceData.baseColor.has_value();
-      output << "ply\n";
-      output << "format ascii 1.0\n";
-      output << "element vertex " << (vertices.size() / 3) << "\n";
-      output << "property float x\n";
-      output << "property float y\n";
-      output << "property float z\n";
-      if (hasColor)
+      void Write(std::span<const std::uint8_t> bytes)
       {
-        output << "property uchar red\n";
-        output << "property uchar green\n";
-        output << "property uchar blue\n";
+        Flush();
+        m_Output.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
       }
-      output << "element face " << triangles.size() << "\n";
-      output << "property list uchar int vertex_indices\n";
-      output << "end_header\n";
 
-      for (std::size_t vertexIndex = 0; vertexIndex < vertices.size() / 3; ++vertexIndex)
+      void Flush()
       {
-        output << vertices[vertexIndex * 3 + 0] << ' '
-               << vertices[vertexIndex * 3 + 1] << ' '
-               << vertices[vertexIndex * 3 + 2];
-        if (hasColor)
+        if (!m_Buffer.empty())
         {
-          output << ' ' << static_cast<unsigned int>(surfaceData.baseColor->r)
-                 << ' ' << static_cast<unsigned int>(surfaceData.baseColor->g)
-                 << ' ' << static_cast<unsigned int>(surfaceData.baseColor->b);
+          m_Output.write(reinterpret_cast<const char*>(m_Buffer.data()), static_cast<std::streamsize>(m_Buffer.size()));
+          m_Buffer.clear();
         }
-        output << '\n';
       }
 
-      for (const auto& triangle : triangles)
+    private:
+      std::ofstream& m_Output;
+      std::vector<std::uint8_t> m_Buffer;
+    };
+
+    // Formats text and numbers with fmt into memory, bypassing the stream's
+    // locale and per-insertion overhead
+    class TextBuffer
+    {
+    public:
+      explicit TextBuffer(const int floatPrecision)
+        : m_FloatPrecision(floatPrecision)
       {
-        output << "3 " << triangle.v1 << ' ' << triangle.v2 << ' ' << triangle.v3 << '\n';
       }
 
-      return output.good();
-    }
+      TextBuffer& operator<<(const std::string_view text)
+      {
+        m_Buffer.append(text.data(), text.data() + text.size());
+        return *this;
+      }
 
-    bool ExportObj(const fs::path& outputPath,
-                   const std::vector<float>& vertices,
-                   const std::vector<Open3SDCM::Triangle>& triangles,
-                   const Open3SDCM::SurfaceData& surfaceData)
+      TextBuffer& operator<<(const char character)
+      {
+        m_Buffer.push_back(character);
+        return *this;
+      }
+
+      TextBuffer& operator<<(const float value)
+      {
+        if (m_FloatPrecision > 0)
+        {
+          fmt::format_to(std::back_inserter(m_Buffer), "{:.{}g}", value, m_FloatPrecision);
+        }
+        else
+        {
+          fmt::format_to(std::back_inserter(m_Buffer), FMT_COMPILE("{}"), value);
+        }
+        return *this;
+      }
+
+      template<typename IntegerT>
+        requires std::is_integral_v<IntegerT>
+      TextBuffer& operator<<(const IntegerT value)
+      {
+        const fmt::format_int formatted(value);
+        m_Buffer.append(formatted.data(), formatted.data() + formatted.size());
+        return *this;
+      }
+
+      [[nodiscard]] std::string_view View() const { return {m_Buffer.data(), m_Buffer.size()}; }
+      void Clear() { m_Buffer.clear(); }
+
+    private:
+      int m_FloatPrecision;
+      fmt::memory_buffer m_Buffer;
+    };
+
+    // Elements (vertices, corners or faces) formatted per task
+    constexpr std::size_t kTextRangeSize = 16384;
+
+    // Formats elements [0, count) in ranges of kTextRangeSize on the shared pool, each
+    // into its own buffer, and writes the buffers to `output` in element order. Ranges
+    // are processed in waves of a few per worker, so only one wave of text is held in
+    // memory. formatRange(buffer, begin, end) must only read shared state.
+    template<typename FormatRange>
+    void WriteTextRanges(std::ofstream& output, const std::size_t count, const int floatPrecision, const FormatRange& formatRange)
+    {
+      const std::size_t rangeCount = (count + kTextRangeSize - 1) / kTextRangeSize;
+      const std::size_t waveSize = std::min(rangeCount, std::max<std::size_t>(1, ThreadPool::Shared().Size() * 4));
+      std::vector<TextBuffer> buffers;
+      buffers.reserve(waveSize);
+      for (std::size_t slot = 0; slot < waveSize; ++slot)
+      {
+        buffers.emplace_back(floatPrecision);
+      }
+
+      for (std::size_t firstRange = 0; firstRange < rangeCount; firstRange += waveSize)
+      {
+        const std::size_t rangesInWave = std::min(waveSize, rangeCount - firstRange);
+        ParallelFor(rangesInWave, 1, [&](const std::size_t beginSlot, const std::size_t endSlot) {
+          for (std::size_t slot = beginSlot; slot < endSlot; ++slot)
+          {
+            const std::size_t begin = (firstRange + slot) * kTextRangeSize;
+            buffers[slot].Clear();
+            formatRange(buffers[slot], begin, std::min(count, begin + kTextRangeSize));
+          }
+        });
+
+        for (std::size_t slot = 0; slot < rangesInWave; ++slot)
+        {
+          const std::string_view text = buffers[slot].View();
+          output.write(text.data(), static_cast<std::streamsize>(text.size()));
+        }
+      }
+    }
+
+    void StoreLittleEndianFloat(std::uint8_t* bytes, const float value)
+    {
+      StoreLittleEndian32(bytes, std::bit_cast<std::uint32_t>(value));
+    }
+
+    enum class PlyEncoding
+    {
+      Ascii,
+      BinaryLittleEndian
+    };
+
+    void WritePlyHeader(std::ostream& output,
+                        const PlyEncoding encoding,
+                        const std::size_t vertexCount,
+                        const std::size_t faceCount,
+                        const bool hasColor,
+                        const bool hasTextureCoordinates)
+    {
+      output << "ply\n";
+      output << (encoding == PlyEncoding::Ascii ? "format ascii 1.0\n" : "format binary_little_endian 1.0\n");
+      output << "element vertex " << vertexCount << "\n";
+      output << "property float x\n";
+      output << "property float y\n";
+      output << "property float z\n";
+      if (hasColor)
+      {
+        output << "property uchar red\n";
+        output << "property uchar green\n";
+        output << "property uchar blue\n";
+      }
+      output << "element face " << faceCount << "\n";
+      output << "property list uchar int vertex_indices\n";
+      if (hasTextureCoordinates)
+      {
+        // Per-corner UVs, as MeshLab reads and writes them
+        output << "property list uchar float texcoord\n";
+      }
+      output << "end_header\n";
+    }
+
+    // Vertex and face records go through a chunk buffer; without color the vertex
+    // block is the little-endian float array itself and is written in one call
+    bool ExportBinaryPly(const fs::path& outputPath,
+                         const std::vector<float>& vertices,
+                         const std::vector<Open3SDCM::Triangle>& triangles,
+                         const Open3SDCM::SurfaceData& surfaceData)
+    {
+      std::ofstream output(outputPath, std::ios::binary);
+      if (!output)
+      {
+        return false;
+      }
+
+      const ExportTextureBinding textureBinding = FindTextureBinding(surfaceData);
+      const bool hasTextureCoordinates = textureBinding.coordinates != nullptr &&
+        textureBinding.coordinates->cornerCoordinates.size() == triangles.size() * 3;
+      const bool hasColor = surfaceData.baseColor.has_value();
+      const std::size_t vertexCount = vertices.size() / 3;
+      WritePlyHeader(output, PlyEncoding::BinaryLittleEndian, vertexCount, triangles.size(), hasColor, hasTextureCoordinates);
+
+      BinaryChunkWriter writer(output);
+      if (!hasColor && std::endian::native == std::endian::little)
+      {
+        writer.Write({reinterpret_cast<const std::uint8_t*>(vertices.data()), vertexCount * 3 * sizeof(float)});
+      }
+      else
+      {
+        const std::size_t recordSize = 3 * sizeof(float) + (hasColor ? 3 : 0);
+        for (std::size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+        {
+          std::uint8_t* record = writer.Append(recordSize);
+          StoreLittleEndianFloat(record + 0, vertices[vertexIndex * 3 + 0]);
+          StoreLittleEndianFloat(record + 4, vertices[vertexIndex * 3 + 1]);
+          StoreLittleEndianFloat(record + 8, vertices[vertexIndex * 3 + 2]);
+          if (hasColor)
+          {
+            record[12] = surfaceData.baseColor->r;
+            record[13] = surfaceData.baseColor->g;
+            record[14] = surfaceData.baseColor->b;
+          }
+        }
+      }
+
+      const std::size_t faceRecordSize = 1 + 3 * sizeof(std::uint32_t) + (hasTextureCoordinates ? 1 + 6 * sizeof(float) : 0);
+      for (std::size_t faceIndex = 0; faceIndex < triangles.size(); ++faceIndex)
+      {
+        const auto& triangle = triangles[faceIndex];
+        std::uint8_t* record = writer.Append(faceRecordSize);
+        record[0] = 3;
+        StoreLittleEndian32(record + 1, triangle.v1);
+        StoreLittleEndian32(record + 5, triangle.v2);
+        StoreLittleEndian32(record + 9, triangle.v3);
+        if (hasTextureCoordinates)
+        {
+          record[13] = 6;
+          for (std::size_t corner = 0; corner < 3; ++corner)
+          {
+            const auto exported = ToExportedTextureCoordinate(textureBinding.coordinates->cornerCoordinates[faceIndex * 3 + corner]);
+            StoreLittleEndianFloat(record + 14 + corner * 8, exported.u);
+            StoreLittleEndianFloat(record + 18 + corner * 8, exported.v);
+          }
+        }
+      }
+      writer.Flush();
+
+      return output.good();
+    }
+
+    // Facet normals are computed a batch of faces at a time over plain arrays,
+    // which the compiler vectorizes, then packed as 50-byte records
+    constexpr std::size_t kStlFaceBatch = 4096;
+    constexpr std::size_t kStlRecordSize = 50;
+
+    struct StlFaceBatch
+    {
+      std::array<std::array<float, kStlFaceBatch>, 9> corners;// x, y, z of the 3 corners
+      std::array<std::array<float, kStlFaceBatch>, 3> normals;
+    };
+
+    void ComputeFacetNormals(StlFaceBatch& batch, const std::size_t count)
+    {
+      const float* ax = batch.corners[0].data();
+      const float* ay = batch.corners[1].data();
+      const float* az = batch.corners[2].data();
+      const float* bx = batch.corners[3].data();
+      const float* by = batch.corners[4].data();
+      const float* bz = batch.corners[5].data();
+      const float* cx = batch.corners[6].data();
+      const float* cy = batch.corners[7].data();
+      const float* cz = batch.corners[8].data();
+      float* nx = batch.normals[0].data();
+      float* ny = batch.normals[1].data();
+      float* nz = batch.normals[2].data();
+
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        const float ux = bx[i] - ax[i];
+        const float uy = by[i] - ay[i];
+        const float uz = bz[i] - az[i];
+        const float vx = cx[i] - ax[i];
+        const float vy = cy[i] - ay[i];
+        const float vz = cz[i] - az[i];
+        const float x = uy * vz - uz * vy;
+        const float y = uz * vx - ux * vz;
+        const float z = ux * vy - uy * vx;
+        const float length = std::sqrt(x * x + y * y + z * z);
+        // Degenerate faces get a zero normal
+        const float scale = length > 0.0F ? 1.0F / length : 0.0F;
+        nx[i] = x * scale;
+        ny[i] = y * scale;
+        nz[i] = z * scale;
+      }
+    }
+
+    bool ExportBinaryStl(const fs::path& outputPath,
+                         const std::vector<float>& vertices,
+                         const std::vector<Open3SDCM::Triangle>& triangles)
+    {
+      if (triangles.size() > std::numeric_limits<std::uint32_t>::max())
+      {
+        return false;
+      }
+
+      if (!EnsureParentDirectoryExists(outputPath))
+      {
+        return false;
+      }
+
+      std::ofstream output(outputPath, std::ios::binary);
+      if (!output)
+      {
+        return false;
+      }
+
+      BinaryChunkWriter writer(output);
+
+      // The header must not start with "solid", which readers take for ASCII STL
+      std::uint8_t* header = writer.Append(80 + sizeof(std::uint32_t));
+      std::memset(header, 0, 80);
+      constexpr std::string_view kHeaderText = "Open3SDCM binary STL";
+      std::memcpy(header, kHeaderText.data(), kHeaderText.size());
+      StoreLittleEndian32(header + 80, static_cast<std::uint32_t>(triangles.size()));
+
+      auto batch = std::make_unique<StlFaceBatch>();
+      for (std::size_t first = 0; first < triangles.size(); first += kStlFaceBatch)
+      {
+        const std::size_t count = std::min(kStlFaceBatch, triangles.size() - first);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+          const auto& triangle = triangles[first + i];
+          const std::array<std::uint32_t, 3> corners = {triangle.v1, triangle.v2, triangle.v3};
+          for (std::size_t corner = 0; corner < 3; ++corner)
+          {
+            const float* position = vertices.data() + static_cast<std::size_t>(corners[corner]) * 3;
+            batch->corners[corner * 3 + 0][i] = position[0];
+            batch->corners[corner * 3 + 1][i] = position[1];
+            batch->corners[corner * 3 + 2][i] = position[2];
+          }
+        }
+
+        ComputeFacetNormals(*batch, count);
+
+        std::uint8_t* record = writer.Append(count * kStlRecordSize);
+        for (std::size_t i = 0; i < count; ++i, record += kStlRecordSize)
+        {
+          for (std::size_t axis = 0; axis < 3; ++axis)
+          {
+            StoreLittleEndianFloat(record + axis * 4, batch->normals[axis][i]);
+          }
+          for (std::size_t component = 0; component < 9; ++component)
+          {
+            StoreLittleEndianFloat(record + 12 + component * 4, batch->corners[component][i]);
+          }
+          record[48] = 0;// attribute byte count
+          record[49] = 0;
+        }
+      }
+      writer.Flush();
+
+      return output.good();
+    }
+
+    bool ExportPly(const fs::path& outputPath,
+                   const std::vector<float>& vertices,
+                   const std::vector<Open3SDCM::Triangle>& triangles,
+                   const Open3SDCM::SurfaceData& surfaceData,
+                   const PlyEncoding encoding,
+                   const Open3SDCM::ExportOptions& options)
+    {
+      if (!EnsureParentDirectoryExists(outputPath))
+      {
+        return false;
+      }
+
+      if (encoding == PlyEncoding::BinaryLittleEndian)
+      {
+        return ExportBinaryPly(outputPath, vertices, triangles, surfaceData);
+      }
+
+      std::ofstream output(outputPath);
+      if (!output)
+      {
+        return false;
+      }
+
+      const bool hasColor = surfaceData.baseColor.has_value();
+      WritePlyHeader(output, PlyEncoding::Ascii, vertices.size() / 3, triangles.size(), hasColor, false);
+
+      // The color is the same on every vertex: format it once
+      std::string colorSuffix = "\n";
+      if (hasColor)
+      {
+        colorSuffix = fmt::format(" {} {} {}\n", surfaceData.baseColor->r, surfaceData.baseColor->g, surfaceData.baseColor->b);
+      }
+
+      WriteTextRanges(output, vertices.size() / 3, options.floatPrecision, [&](TextBuffer& text, const std::size_t begin, const std::size_t end) {
+        for (std::size_t vertexIndex = begin; vertexIndex < end; ++vertexIndex)
+        {
+          text << vertices[vertexIndex * 3 + 0] << ' '
+               << vertices[vertexIndex * 3 + 1] << ' '
+               << vertices[vertexIndex * 3 + 2] << std::string_view(colorSuffix);
+        }
+      });
+
+      WriteTextRanges(output, triangles.size(), options.floatPrecision, [&](TextBuffer& text, const std::size_t begin, const std::size_t end) {
+        for (std::size_t faceIndex = begin; faceIndex < end; ++faceIndex)
+        {
+          const auto& triangle = triangles[faceIndex];
+          text << "3 " << triangle.v1 << ' ' << triangle.v2 << ' ' << triangle.v3 << '\n';
+        }
+      });
+
+      return output.good();
+    }
+
+    // Texture coordinates as an exporter writes them, each distinct value once,
+    // and the index of every triangle corner's value
+    struct IndexedTextureCoordinates
+    {
+      std::vector<Open3SDCM::TextureCoordinate> values;
+      std::vector<std::uint32_t> cornerIndices;
+    };
+
+    // toExported maps a decoded corner coordinate to the written value (e.g. V flipped).
+    // Most vertices carry a single UV shared by all their corners, so a corner is first
+    // compared with the last value of its vertex; other values are looked up by their bits.
+    template<typename ToExported>
+    IndexedTextureCoordinates IndexTextureCoordinates(const std::vector<std::optional<Open3SDCM::TextureCoordinate>>& cornerCoordinates,
+                                                      const std::vector<Open3SDCM::Triangle>& triangles,
+                                                      const std::size_t vertexCount,
+                                                      const ToExported& toExported)
+    {
+      constexpr std::uint32_t kNoValue = std::numeric_limits<std::uint32_t>::max();
+      const auto valueKey = [](const Open3SDCM::TextureCoordinate& coordinate) {
+        return (static_cast<std::uint64_t>(std::bit_cast<std::uint32_t>(coordinate.u)) << 32U) |
+               std::bit_cast<std::uint32_t>(coordinate.v);
+      };
+
+      IndexedTextureCoordinates indexed;
+      indexed.cornerIndices.resize(cornerCoordinates.size());
+      std::vector<std::uint64_t> keys;
+      std::vector<std::uint32_t> lastValueOfVertex(vertexCount, kNoValue);
+      std::unordered_map<std::uint64_t, std::uint32_t> valueIndices;
+
+      for (std::size_t cornerIndex = 0; cornerIndex < cornerCoordinates.size(); ++cornerIndex)
+      {
+        const Open3SDCM::TextureCoordinate value = toExported(cornerCoordinates[cornerIndex]);
+        const std::uint64_t key = valueKey(value);
+        const auto& triangle = triangles[cornerIndex / 3];
+        const std::uint32_t vertexIndex = cornerIndex % 3 == 0 ? triangle.v1 : cornerIndex % 3 == 1 ? triangle.v2 : triangle.v3;
+
+        std::uint32_t& lastValue = lastValueOfVertex[vertexIndex];
+        if (lastValue == kNoValue || keys[lastValue] != key)
+        {
+          const auto [it, inserted] = valueIndices.try_emplace(key, static_cast<std::uint32_t>(indexed.values.size()));
+          if (inserted)
+          {
+            indexed.values.push_back(value);
+            keys.push_back(key);
+          }
+          lastValue = it->second;
+        }
+        indexed.cornerIndices[cornerIndex] = lastValue;
+      }
+
+      return indexed;
+    }
+
+    bool ExportObj(const fs::path& outputPath,
+                   const std::vector<float>& vertices,
+                   const std::vector<Open3SDCM::Triangle>& triangles,
+                   const Open3SDCM::SurfaceData& surfaceData,
+                   const Open3SDCM::ExportOptions& options)
     {
       if (!EnsureParentDirectoryExists(outputPath))
       {
@@ -1258,55 +2130,391 @@ namespace Open3SDCM
         output << "usemtl material0\n";
       }
 
-      for (std::size_t vertexIndex = 0; vertexIndex < vertices.size() / 3; ++vertexIndex)
-      {
-        output << "v "
+      WriteTextRanges(output, vertices.size() / 3, options.floatPrecision, [&](TextBuffer& text, const std::size_t begin, const std::size_t end) {
+        for (std::size_t vertexIndex = begin; vertexIndex < end; ++vertexIndex)
+        {
+          text << "v "
                << vertices[vertexIndex * 3 + 0] << ' '
                << vertices[vertexIndex * 3 + 1] << ' '
-               << vertices[vertexIndex * 3 + 2] << "\n";
+               << vertices[vertexIndex * 3 + 2] << '\n';
+        }
+      });
+
+      const bool indexTextureCoordinates = hasTextureCoordinates && options.deduplicateTextureCoordinates;
+      IndexedTextureCoordinates indexed;
+      if (indexTextureCoordinates)
+      {
+        indexed = IndexTextureCoordinates(textureBinding.coordinates->cornerCoordinates,
+                                          triangles,
+                                          vertices.size() / 3,
+                                          ToExportedTextureCoordinate);
+        WriteTextRanges(output, indexed.values.size(), options.floatPrecision, [&](TextBuffer& text, const std::size_t begin, const std::size_t end) {
+          for (std::size_t valueIndex = begin; valueIndex < end; ++valueIndex)
+          {
+            text << "vt " << indexed.values[valueIndex].u << ' ' << indexed.values[valueIndex].v << '\n';
+          }
+        });
+      }
+      else if (hasTextureCoordinates)
+      {
+        const auto& cornerCoordinates = textureBinding.coordinates->cornerCoordinates;
+        WriteTextRanges(output, cornerCoordinates.size(), options.floatPrecision, [&](TextBuffer& text, const std::size_t begin, const std::size_t end) {
+          for (std::size_t cornerIndex = begin; cornerIndex < end; ++cornerIndex)
+          {
+            const auto exported = ToExportedTextureCoordinate(cornerCoordinates[cornerIndex]);
+            text << "vt " << exported.u << ' ' << exported.v << '\n';
+          }
+        });
       }
 
-      if (hasTextureCoordinates)
+      // 1-based "vt" index of a triangle corner
+      const auto textureIndex = [&](const std::size_t cornerIndex) -> std::size_t {
+        return (indexTextureCoordinates ? indexed.cornerIndices[cornerIndex] : cornerIndex) + 1;
+      };
+
+      WriteTextRanges(output, triangles.size(), options.floatPrecision, [&](TextBuffer& text, const std::size_t begin, const std::size_t end) {
+        for (std::size_t faceIndex = begin; faceIndex < end; ++faceIndex)
+        {
+          const auto& triangle = triangles[faceIndex];
+          if (hasTextureCoordinates)
+          {
+            text << "f "
+                 << (triangle.v1 + 1) << '/' << textureIndex(faceIndex * 3 + 0) << ' '
+                 << (triangle.v2 + 1) << '/' << textureIndex(faceIndex * 3 + 1) << ' '
+                 << (triangle.v3 + 1) << '/' << textureIndex(faceIndex * 3 + 2) << '\n';
+          }
+          else
+          {
+            text << "f "
+                 << (triangle.v1 + 1) << ' '
+                 << (triangle.v2 + 1) << ' '
+                 << (triangle.v3 + 1) << '\n';
+          }
+        }
+      });
+
+      return output.good();
+    }
+
+    // glTF wants linear color factors; the DCM base color is 8-bit sRGB
+    float SrgbToLinear(const std::uint8_t value)
+    {
+      const float normalized = NormalizeColorChannel(value);
+      return normalized <= 0.04045F ? normalized / 12.92F : std::pow((normalized + 0.055F) / 1.055F, 2.4F);
+    }
+
+    // Writes 32-bit words (floats or indices) in little-endian order; straight from
+    // the caller's memory on little-endian hosts
+    template<typename WordT>
+    void WriteLittleEndianWords(BinaryChunkWriter& writer, const std::span<const WordT> words)
+    {
+      static_assert(sizeof(WordT) == 4);
+      if constexpr (std::endian::native == std::endian::little)
+      {
+        writer.Write({reinterpret_cast<const std::uint8_t*>(words.data()), words.size_bytes()});
+      }
+      else
       {
-        for (const auto& cornerCoordinate : textureBinding.coordinates->cornerCoordinates)
+        for (const WordT word : words)
         {
-          const auto resolvedCoordinate = cornerCoordinate.value_or(Open3SDCM::TextureCoordinate{});
-          // The decoded CE texture coordinates use the image's top-left origin,
-          // while OBJ consumers expect V to be measured from the bottom edge.
-          const float exportedV = cornerCoordinate.has_value() ? 1.0F - resolvedCoordinate.v : resolvedCoordinate.v;
-          output << "vt " << resolvedCoordinate.u << ' ' << exportedV << "\n";
+          StoreLittleEndian32(writer.Append(4), std::bit_cast<std::uint32_t>(word));
         }
       }
+    }
 
-      for (std::size_t faceIndex = 0; faceIndex < triangles.size(); ++faceIndex)
+    // glTF core only knows JPEG and PNG images; empty if the texture is neither
+    std::string_view GlbImageMimeType(const Open3SDCM::EmbeddedTextureImage& textureImage)
+    {
+      const std::string extension = GuessTextureExtension(textureImage);
+      const auto& bytes = textureImage.imageBytes;
+      if (bytes.empty())
       {
-        const auto& triangle = triangles[faceIndex];
-        if (hasTextureCoordinates)
+        return {};
+      }
+      if (extension == ".jpg" || (bytes.size() >= 2 && bytes[0] == 0xFF && bytes[1] == 0xD8))
+      {
+        return "image/jpeg";
+      }
+      if (extension == ".png" || (bytes.size() >= 4 && bytes[0] == 0x89 && bytes[1] == 'P' && bytes[2] == 'N' && bytes[3] == 'G'))
+      {
+        return "image/png";
+      }
+      return {};
+    }
+
+    constexpr std::size_t AlignTo4(const std::size_t size)
+    {
+      return (size + 3U) & ~std::size_t{3};
+    }
+
+    // One textured (or colored) triangle mesh as a binary glTF 2.0 file. Without UVs
+    // the positions and indices are written straight from the parser's buffers. With
+    // UVs a vertex is split once per distinct UV among its corners (seams only).
+    // The embedded JPEG/PNG is stored as is in the binary chunk.
+    bool ExportGlb(const fs::path& outputPath,
+                   const std::vector<float>& vertices,
+                   const std::vector<Open3SDCM::Triangle>& triangles,
+                   const Open3SDCM::SurfaceData& surfaceData)
+    {
+      if (!EnsureParentDirectoryExists(outputPath))
+      {
+        return false;
+      }
+
+      const ExportTextureBinding textureBinding = FindTextureBinding(surfaceData);
+      const bool hasTextureCoordinates = textureBinding.coordinates != nullptr &&
+        textureBinding.coordinates->cornerCoordinates.size() == triangles.size() * 3;
+      const std::string_view imageMimeType = hasTextureCoordinates && textureBinding.image != nullptr ? GlbImageMimeType(*textureBinding.image) : std::string_view();
+      const bool hasTextureImage = !imageMimeType.empty();
+
+      // Split vertices at UV seams: one output vertex per (vertex, UV) pair in use
+      std::vector<float> splitPositions;
+      std::vector<Open3SDCM::TextureCoordinate> splitTextureCoordinates;
+      std::vector<std::uint32_t> splitIndices;
+      if (hasTextureCoordinates)
+      {
+        const std::size_t vertexCount = vertices.size() / 3;
+        // glTF UVs have the top-left origin the DCM coordinates already use
+        const auto indexed = IndexTextureCoordinates(textureBinding.coordinates->cornerCoordinates,
+                                                     triangles,
+                                                     vertexCount,
+                                                     [](const std::optional<Open3SDCM::TextureCoordinate>& coordinate) {
+                                                       return coordinate.value_or(Open3SDCM::TextureCoordinate{});
+                                                     });
+
+        constexpr std::uint32_t kNoVertex = std::numeric_limits<std::uint32_t>::max();
+        std::vector<std::uint32_t> lastSplitOfVertex(vertexCount, kNoVertex);
+        std::vector<std::uint32_t> splitValue;// UV value index of every output vertex
+        std::unordered_map<std::uint64_t, std::uint32_t> splitOfPair;
+        const std::span<const std::uint32_t> cornerVertices = AsIndexBuffer(triangles);
+        splitIndices.resize(cornerVertices.size());
+
+        for (std::size_t cornerIndex = 0; cornerIndex < cornerVertices.size(); ++cornerIndex)
         {
-          output << "f "
-                 << (triangle.v1 + 1) << '/' << (faceIndex * 3 + 1) << ' '
-                 << (triangle.v2 + 1) << '/' << (faceIndex * 3 + 2) << ' '
-                 << (triangle.v3 + 1) << '/' << (faceIndex * 3 + 3) << "\n";
+          const std::uint32_t vertexIndex = cornerVertices[cornerIndex];
+          const std::uint32_t valueIndex = indexed.cornerIndices[cornerIndex];
+          std::uint32_t& lastSplit = lastSplitOfVertex[vertexIndex];
+          if (lastSplit == kNoVertex || splitValue[lastSplit] != valueIndex)
+          {
+            const std::uint64_t pair = (static_cast<std::uint64_t>(vertexIndex) << 32U) | valueIndex;
+            const auto [it, inserted] = splitOfPair.try_emplace(pair, static_cast<std::uint32_t>(splitValue.size()));
+            if (inserted)
+            {
+              splitValue.push_back(valueIndex);
+              splitPositions.insert(splitPositions.end(), vertices.begin() + vertexIndex * 3, vertices.begin() + vertexIndex * 3 + 3);
+              splitTextureCoordinates.push_back(indexed.values[valueIndex]);
+            }
+            lastSplit = it->second;
+          }
+          splitIndices[cornerIndex] = lastSplit;
         }
-        else
+      }
+
+      const std::span<const float> positions = hasTextureCoordinates ? std::span<const float>(splitPositions) : std::span<const float>(vertices);
+      const std::span<const std::uint32_t> indices = hasTextureCoordinates ? std::span<const std::uint32_t>(splitIndices) : AsIndexBuffer(triangles);
+      const std::size_t outputVertexCount = positions.size() / 3;
+
+      std::array<float, 3> minimum = {0.0F, 0.0F, 0.0F};
+      std::array<float, 3> maximum = {0.0F, 0.0F, 0.0F};
+      for (std::size_t vertexIndex = 0; vertexIndex < outputVertexCount; ++vertexIndex)
+      {
+        for (std::size_t axis = 0; axis < 3; ++axis)
         {
-          output << "f "
-                 << (triangle.v1 + 1) << ' '
-                 << (triangle.v2 + 1) << ' '
-                 << (triangle.v3 + 1) << "\n";
+          const float value = positions[vertexIndex * 3 + axis];
+          minimum[axis] = vertexIndex == 0 ? value : std::min(minimum[axis], value);
+          maximum[axis] = vertexIndex == 0 ? value : std::max(maximum[axis], value);
         }
       }
 
+      // Binary chunk layout: positions, UVs, indices, image; every view 4-byte aligned
+      const std::size_t positionsOffset = 0;
+      const std::size_t positionsSize = positions.size_bytes();
+      const std::size_t uvOffset = positionsOffset + positionsSize;
+      const std::size_t uvSize = hasTextureCoordinates ? splitTextureCoordinates.size() * 2 * sizeof(float) : 0;
+      const std::size_t indicesOffset = uvOffset + uvSize;
+      const std::size_t indicesSize = indices.size_bytes();
+      const std::size_t imageOffset = indicesOffset + indicesSize;
+      const std::size_t imageSize = hasTextureImage ? textureBinding.image->imageBytes.size() : 0;
+      const std::size_t binarySize = AlignTo4(imageOffset + imageSize);
+
+      fmt::memory_buffer json;
+      auto out = std::back_inserter(json);
+      fmt::format_to(out, R"({{"asset":{{"version":"2.0","generator":"Open3SDCM"}},"scene":0,"scenes":[{{"nodes":[0]}}],"nodes":[{{"mesh":0}}],)");
+      fmt::format_to(out, R"("meshes":[{{"primitives":[{{"attributes":{{"POSITION":0{}}},"indices":{},"material":0,"mode":4}}]}}],)",
+                     hasTextureCoordinates ? R"(,"TEXCOORD_0":1)" : "",
+                     hasTextureCoordinates ? 2 : 1);
+
+      std::array<float, 4> baseColorFactor = {1.0F, 1.0F, 1.0F, 1.0F};
+      if (!hasTextureImage && surfaceData.baseColor.has_value())
+      {
+        baseColorFactor = {SrgbToLinear(surfaceData.baseColor->r), SrgbToLinear(surfaceData.baseColor->g), SrgbToLinear(surfaceData.baseColor->b), 1.0F};
+      }
+      fmt::format_to(out, R"("materials":[{{"pbrMetallicRoughness":{{"baseColorFactor":[{},{},{},{}],)",
+                     baseColorFactor[0], baseColorFactor[1], baseColorFactor[2], baseColorFactor[3]);
+      if (hasTextureImage)
+      {
+        fmt::format_to(out, R"("baseColorTexture":{{"index":0}},)");
+      }
+      fmt::format_to(out, R"("metallicFactor":0,"roughnessFactor":1}}}}],)");
+      if (hasTextureImage)
+      {
+        fmt::format_to(out, R"("textures":[{{"source":0,"sampler":0}}],"samplers":[{{"magFilter":9729,"minFilter":9987}}],)");
+        fmt::format_to(out, R"("images":[{{"bufferView":{},"mimeType":"{}"}}],)",
+                       3, imageMimeType);
+      }
+
+      fmt::format_to(out, R"("accessors":[{{"bufferView":0,"componentType":5126,"count":{},"type":"VEC3","min":[{},{},{}],"max":[{},{},{}]}})",
+                     outputVertexCount, minimum[0], minimum[1], minimum[2], maximum[0], maximum[1], maximum[2]);
+      std::size_t bufferViewIndex = 1;
+      if (hasTextureCoordinates)
+      {
+        fmt::format_to(out, R"(,{{"bufferView":{},"componentType":5126,"count":{},"type":"VEC2"}})", bufferViewIndex++, outputVertexCount);
+      }
+      fmt::format_to(out, R"(,{{"bufferView":{},"componentType":5125,"count":{},"type":"SCALAR"}}],)", bufferViewIndex, indices.size());
+
+      fmt::format_to(out, R"("bufferViews":[{{"buffer":0,"byteOffset":{},"byteLength":{},"target":34962}})", positionsOffset, positionsSize);
+      if (hasTextureCoordinates)
+      {
+        fmt::format_to(out, R"(,{{"buffer":0,"byteOffset":{},"byteLength":{},"target":34962}})", uvOffset, uvSize);
+      }
+      fmt::format_to(out, R"(,{{"buffer":0,"byteOffset":{},"byteLength":{},"target":34963}})", indicesOffset, indicesSize);
+      if (hasTextureImage)
+      {
+        fmt::format_to(out, R"(,{{"buffer":0,"byteOffset":{},"byteLength":{}}})", imageOffset, imageSize);
+      }
+      fmt::format_to(out, R"(],"buffers":[{{"byteLength":{}}}]}})", binarySize);
+      // The JSON chunk is padded with spaces
+      while (json.size() % 4 != 0)
+      {
+        json.push_back(' ');
+      }
+
+      const std::size_t totalSize = 12 + 8 + json.size() + 8 + binarySize;
+      if (totalSize > std::numeric_limits<std::uint32_t>::max())
+      {
+        return false;
+      }
+
+      std::ofstream output(outputPath, std::ios::binary);
+      if (!output)
+      {
+        return false;
+      }
+
+      BinaryChunkWriter writer(output);
+      std::uint8_t* header = writer.Append(12 + 8);
+      StoreLittleEndian32(header + 0, 0x46546C67U);// "glTF"
+      StoreLittleEndian32(header + 4, 2);
+      StoreLittleEndian32(header + 8, static_cast<std::uint32_t>(totalSize));
+      StoreLittleEndian32(header + 12, static_cast<std::uint32_t>(json.size()));
+      StoreLittleEndian32(header + 16, 0x4E4F534AU);// "JSON"
+      writer.Write({reinterpret_cast<const std::uint8_t*>(json.data()), json.size()});
+
+      std::uint8_t* binaryHeader = writer.Append(8);
+      StoreLittleEndian32(binaryHeader + 0, static_cast<std::uint32_t>(binarySize));
+      StoreLittleEndian32(binaryHeader + 4, 0x004E4942U);// "BIN\0"
+      WriteLittleEndianWords(writer, positions);
+      if (hasTextureCoordinates)
+      {
+        WriteLittleEndianWords(writer, std::span<const float>(reinterpret_cast<const float*>(splitTextureCoordinates.data()),
+                                                              splitTextureCoordinates.size() * 2));
+      }
+      WriteLittleEndianWords(writer, indices);
+      if (hasTextureImage)
+      {
+        writer.Write(textureBinding.image->imageBytes);
+      }
+      std::memset(writer.Append(binarySize - (imageOffset + imageSize)), 0, binarySize - (imageOffset + imageSize));
+      writer.Flush();
+
       return output.good();
     }
 
+    // Adds one ExportMesh call to the stats of a parse that collected them
+    class ExportTimer
+    {
+    public:
+      ExportTimer(Open3SDCM::ParseStats& stats, const std::string& format, const fs::path& outputPath)
+        : m_Stats(stats), m_Format(format), m_OutputPath(outputPath)
+      {
+        if (m_Stats.collected)
+        {
+          m_Start = std::chrono::steady_clock::now();
+        }
+      }
+
+      ~ExportTimer()
+      {
+        if (!m_Stats.collected)
+        {
+          return;
+        }
+
+        Open3SDCM::StageTiming& timing = m_Stats.exports[m_Format];
+        timing.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_Start).count();
+        ++timing.calls;
+        std::error_code errorCode;
+        const auto outputSize = fs::file_size(m_OutputPath, errorCode);
+        timing.bytes += errorCode ? 0 : outputSize;
+      }
+
+      ExportTimer(const ExportTimer&) = delete;
+      ExportTimer& operator=(const ExportTimer&) = delete;
+
+    private:
+      Open3SDCM::ParseStats& m_Stats;
+      const std::string& m_Format;
+      const fs::path& m_OutputPath;
+      std::chrono::steady_clock::time_point m_Start;
+    };
   }// namespace detail
 
-  void DCMParser::ParseDCM(const fs::path& filePath)
+  DCMParser::DCMParser() = default;
+  DCMParser::DCMParser(std::pmr::memory_resource* documentResource) : m_DocumentResource(documentResource) {}
+  DCMParser::~DCMParser() = default;
+  DCMParser::DCMParser(DCMParser&&) noexcept = default;
+  DCMParser& DCMParser::operator=(DCMParser&&) noexcept = default;
+
+  detail::ParseScratch& DCMParser::Scratch()
+  {
+    if (!m_Scratch)
+    {
+      m_Scratch = std::make_unique<detail::ParseScratch>();
+    }
+    return *m_Scratch;
+  }
+
+  std::size_t DCMParser::RetainedScratchBytes() const
+  {
+    return m_Scratch ? m_Scratch->RetainedBytes() : 0;
+  }
+
+  void DCMParser::ReleaseScratch()
+  {
+    m_Scratch.reset();
+  }
+
+  std::size_t DCMParser::RetainedBufferBytes() const
+  {
+    return RetainedScratchBytes() + m_Vertices.capacity() * sizeof(float) + m_Triangles.capacity() * sizeof(Triangle);
+  }
+
+  void DCMParser::ResetResult(const ParseOptions& options)
   {
     m_Vertices.clear();
     m_Triangles.clear();
-    m_SurfaceData = {};
+    m_FacetDecodeInfo = {};
+    Scratch().Recycle(m_SurfaceData);
+    if (options.retainedBufferBudget > 0)
+    {
+      Scratch().Trim(options.retainedBufferBudget, &m_Vertices, &m_Triangles);
+    }
+  }
+
+  void DCMParser::ParseDCM(const fs::path& filePath, const ParseOptions& options)
+  {
+    const detail::StatsSession statsSession(options.collectStats, m_Stats);
+    ResetResult(options);
 
     try
     {
@@ -1317,113 +2525,164 @@ namespace Open3SDCM
         throw Poco::FileNotFoundException(fmt::format("File not found: {}", filePath.string()));
       }
 
-      std::ifstream fileStream(filePath);
-      std::stringstream buffer;
-      buffer << fileStream.rdbuf();
-      std::string fileContent = buffer.str();
+      // Map the file once; the XML scan and the base64 decoders read it in place
+      detail::StageTimer readTimer(detail::ParseStage::FileRead);
+      const detail::MappedFile fileContent(filePath);
+      if (detail::BoundStatsCollector() != nullptr)
+      {
+        // Fault the pages in now, so that storage time is not charged to the XML scan
+        fileContent.Prefetch();
+      }
+      readTimer.AddBytes(fileContent.Size());
+      readTimer.Stop();
+      ParseDCMBuffer(fileContent.View(), filePath, options);
+    }
+    catch (const Poco::Exception& ex)
+    {
+      O3SDCM_LOG_ERROR("Poco Exception: {}", ex.displayText());
+    }
+    catch (const std::exception& ex)
+    {
+      O3SDCM_LOG_ERROR("Exception: {}", ex.what());
+    }
+  }
 
-      // Parse the XML content
-      Poco::XML::DOMParser parser;
+  void DCMParser::ParseDCMBuffer(std::string_view content, const fs::path& sourcePath, const ParseOptions& options)
+  {
+    const detail::StatsSession statsSession(options.collectStats, m_Stats);
+    if (options.cacheDirectory.empty())
+    {
+      ParseDCMBuffer(content, options);
+      return;
+    }
 
-      Poco::AutoPtr<Poco::XML::Document> document = parser.parseString(fileContent);
+    detail::StageTimer loadTimer(detail::ParseStage::CacheLoad, content.size());
+    const detail::ContentHash sourceHash = detail::HashContent(content);
+    const fs::path cachePath = detail::MeshCachePath(options.cacheDirectory, sourcePath);
+    auto cached = detail::ReadMeshCache(cachePath, sourceHash);
+    loadTimer.Stop();
+    if (cached.has_value())
+    {
+      AdoptDecodedMesh(std::move(*cached));
+      return;
+    }
 
-      std::string schema;
-      if (Poco::AutoPtr<Poco::XML::NodeList> versionNodes = document->getElementsByTagName("HPS");
-          versionNodes->length() > 0)
+    ParseDCMBuffer(content, options);
+    // Decoding is deterministic for a given kDecoderRevision, so even a partial result
+    // is what a re-parse would give; only a file that yielded no geometry at all is
+    // left uncached
+    if (!m_Vertices.empty())
+    {
+      detail::StageTimer storeTimer(detail::ParseStage::CacheStore);
+      if (detail::WriteMeshCache(cachePath, sourceHash, m_Vertices, m_Triangles, m_SurfaceData, m_FacetDecodeInfo))
       {
-        auto versionElement = dynamic_cast<Poco::XML::Element*>(versionNodes->item(0));
-        std::string version = versionElement->getAttribute("version");
+        std::error_code errorCode;
+        const auto cacheSize = fs::file_size(cachePath, errorCode);
+        storeTimer.AddBytes(errorCode ? 0 : cacheSize);
       }
+    }
+  }
+
+  bool DCMParser::WriteCache(const fs::path& cachePath, const fs::path& sourcePath) const
+  {
+    const detail::MappedFile source(sourcePath);
+    return detail::WriteMeshCache(cachePath, detail::HashContent(source.View()), m_Vertices, m_Triangles, m_SurfaceData, m_FacetDecodeInfo);
+  }
+
+  bool DCMParser::LoadCache(const fs::path& cachePath, const fs::path& sourcePath)
+  {
+    const detail::MappedFile source(sourcePath);
+    auto cached = detail::ReadMeshCache(cachePath, detail::HashContent(source.View()));
+    if (!cached.has_value())
+    {
+      return false;
+    }
+
+    AdoptDecodedMesh(std::move(*cached));
+    return true;
+  }
+
+  void DCMParser::AdoptDecodedMesh(detail::DecodedMesh&& mesh)
+  {
+    Scratch().Recycle(m_SurfaceData);
+    m_Vertices = std::move(mesh.vertices);
+    m_Triangles = std::move(mesh.triangles);
+    m_SurfaceData = std::move(mesh.surfaceData);
+    m_FacetDecodeInfo = mesh.facetDecodeInfo;
+  }
 
-      if (Poco::AutoPtr<Poco::XML::NodeList> schemaNodes = document->getElementsByTagName("Schema");
-          schemaNodes->length() > 0)
+  void DCMParser::ParseDCMBuffer(std::string_view content, const ParseOptions& options)
+  {
+    const detail::StatsSession statsSession(options.collectStats, m_Stats);
+    ResetResult(options);
+
+    try
+    {
+      // Scan the XML content in a single forward pass. The document dies with this
+      // call, so the arena of the previous one can be rewound for it.
+      std::pmr::memory_resource* documentResource = m_DocumentResource;
+      if (documentResource == nullptr)
       {
-        auto schemaElement = dynamic_cast<Poco::XML::Element*>(schemaNodes->item(0));
-        // Get the text content of the Schema element
-        if (schemaElement->hasChildNodes())
-        {
-          auto firstChild = schemaElement->firstChild();
-          if (firstChild)
-          {
-            schema = firstChild->nodeValue();
-          }
-        }
+        Scratch().arena.Reset();
+        documentResource = &Scratch().arena;
       }
+      detail::StageTimer scanTimer(detail::ParseStage::XmlParse, content.size());
+      const detail::DcmDocument document = detail::ScanDcmDocument(content, documentResource);
+      scanTimer.Stop();
 
-      std::map<std::string, std::string> properties;
-      if (Poco::AutoPtr<Poco::XML::NodeList> propertyNodes = document->getElementsByTagName("Property");
-          propertyNodes->length() > 0)
+      if (options.concurrentDecode)
+      {
+        ParseConcurrently(document);
+      }
+      else
       {
-        for (unsigned long i = 0; i < propertyNodes->length(); ++i)
+        if (document.hasBinaryData)
         {
-            auto propertyElement = dynamic_cast<Poco::XML::Element*>(propertyNodes->item(i));
-            if (propertyElement) {
-                std::string name = propertyElement->getAttribute("name");
-                std::string value = propertyElement->getAttribute("value");
-                if (!name.empty()) {
-                    properties[name] = value;
-                }
-            }
+          ParseBinaryData(document);
         }
-      }
 
-      if (Poco::AutoPtr<Poco::XML::NodeList> GeometryBinaryNodes = document->getElementsByTagName("Binary_data");
-          GeometryBinaryNodes->length() > 0)
-      {
-        auto GeometryBinaryElement = dynamic_cast<Poco::XML::Element*>(GeometryBinaryNodes->item(0));
-        ParseBinaryData(GeometryBinaryNodes, schema, properties);
+        detail::ParseSurfaceData(document, m_Vertices.size() / 3, m_Triangles, Scratch(), m_SurfaceData);
       }
-
-      detail::ParseSurfaceData(document, schema, properties, m_Vertices.size() / 3, m_Triangles, m_SurfaceData);
     }
     catch (const Poco::XML::XMLException& ex)
     {
-      std::cerr << "Poco XML Exception: " << ex.displayText() << std::endl;
+      O3SDCM_LOG_ERROR("Poco XML Exception: {}", ex.displayText());
     }
     catch (const Poco::Exception& ex)
     {
-      std::cerr << "Poco Exception: " << ex.displayText() << std::endl;
+      O3SDCM_LOG_ERROR("Poco Exception: {}", ex.displayText());
     }
     catch (const std::exception& ex)
     {
-      std::cerr << "Exception: " << ex.what() << std::endl;
+      O3SDCM_LOG_ERROR("Exception: {}", ex.what());
+    }
+
+    // The result stays whole; only the scratch buffers are held to the budget between files
+    if (options.retainedBufferBudget > 0)
+    {
+      Scratch().Trim(options.retainedBufferBudget);
     }
   }
 
-  void DCMParser::ParseBinaryData(Poco::AutoPtr<Poco::XML::NodeList> BinaryNodes, const std::string& schema, const std::map<std::string, std::string>& properties)
+  void DCMParser::ParseBinaryData(const detail::DcmDocument& document)
   {
     try
     {
-      auto NbVertices = detail::GetElemCount(BinaryNodes, "Vertices");
-      auto NbFaces = detail::GetElemCount(BinaryNodes, "Facets");
-      fmt::print("Expected to get {} vertices\n", NbVertices);
-      fmt::print("Expected to get {} faces\n", NbFaces);
+      const std::string_view schema = document.schema;
+      const detail::PropertyMap& properties = document.properties;
+      auto NbVertices = detail::GetElemCount(document.vertices, "Vertices");
+      auto NbFaces = detail::GetElemCount(document.facets, "Facets");
+      O3SDCM_LOG_DEBUG("Expected to get {} vertices and {} faces", NbVertices, NbFaces);
 
-      m_SurfaceData.baseColor = detail::ParseFacetBaseColor(BinaryNodes);
+      m_SurfaceData.baseColor = detail::ParseFacetBaseColor(document.facets);
 
       //Parse vertices
-      m_Vertices = detail::ParseVertices(BinaryNodes, schema, properties);
-      fmt::print(" {} floats ({} vertices) have been read from buffer\n", m_Vertices.size(), m_Vertices.size() / 3);
-      if (m_Vertices.size() != NbVertices * 3)
-      {
-        fmt::print("Error: Expected to get {} floats but got {}\n", NbVertices * 3, m_Vertices.size());
-      }
-      else
-      {
-        fmt::print("Get Correct number of vertices\n");
-      }
+      detail::ParseVertices(document.vertices, schema, properties, m_Vertices);
+      detail::ReportVertexCount(m_Vertices.size(), NbVertices);
 
       //Parse facets
-      m_Triangles = detail::ParseFacets(BinaryNodes, schema, properties);
-      fmt::print(" {} triangles have been read from buffer\n", m_Triangles.size());
-      if (m_Triangles.size() != NbFaces)
-      {
-        fmt::print("Error: Expected to get {} faces but got {}\n", NbFaces, m_Triangles.size());
-      }
-      else
-      {
-        fmt::print("Get Correct number of faces\n");
-      }
+      detail::ParseFacets(document.facets, schema, properties, m_FacetDecodeInfo, Scratch().facets, m_Triangles);
+      detail::ReportFacetCount(m_Triangles.size(), NbFaces, m_FacetDecodeInfo);
     }
     catch (const Poco::Exception& ex)
     {
@@ -1431,11 +2690,107 @@ namespace Open3SDCM
     }
   }
 
-  bool DCMParser::ExportMesh(const fs::path& outputPath, const std::string& format) const
+  void DCMParser::ParseConcurrently(const detail::DcmDocument& document)
+  {
+    detail::ParseScratch& scratch = Scratch();
+    const std::string_view schema = document.schema;
+    const detail::PropertyMap& properties = document.properties;
+
+    std::size_t NbVertices = 0;
+    std::size_t NbFaces = 0;
+    if (document.hasBinaryData)
+    {
+      NbVertices = detail::GetElemCount(document.vertices, "Vertices");
+      NbFaces = detail::GetElemCount(document.facets, "Facets");
+      O3SDCM_LOG_DEBUG("Expected to get {} vertices and {} faces", NbVertices, NbFaces);
+      m_SurfaceData.baseColor = detail::ParseFacetBaseColor(document.facets);
+    }
+
+    // First wave: every payload that only depends on its own element. As in
+    // ParseBinaryData, a failed vertex or facet decode leaves that buffer as is.
+    std::vector<std::function<void()>> payloadTasks;
+    if (document.hasBinaryData)
+    {
+      payloadTasks.emplace_back([&] {
+        try
+        {
+          detail::ParseVertices(document.vertices, schema, properties, m_Vertices);
+        }
+        catch (const Poco::Exception&)
+        {
+        }
+      });
+      payloadTasks.emplace_back([&] {
+        try
+        {
+          detail::ParseFacets(document.facets, schema, properties, m_FacetDecodeInfo, scratch.facets, m_Triangles);
+        }
+        catch (const Poco::Exception&)
+        {
+        }
+      });
+    }
+
+    // The tasks only touch their own slot, lent a pooled buffer beforehand
+    auto& textureCoordinates = m_SurfaceData.textureCoordinates;
+    textureCoordinates.resize(document.textureCoordinates.size());
+    auto& uvStreams = scratch.UvStreams(textureCoordinates.size());
+    for (std::size_t i = 0; i < textureCoordinates.size(); ++i)
+    {
+      scratch.Lend(textureCoordinates[i]);
+      payloadTasks.emplace_back([&, i] {
+        detail::ReadTextureCoordinateStreamInto(document.textureCoordinates[i], schema, properties, textureCoordinates[i], uvStreams[i]);
+      });
+    }
+
+    auto& textureImages = m_SurfaceData.textureImages;
+    textureImages.resize(document.textureImages.size());
+    for (std::size_t i = 0; i < textureImages.size(); ++i)
+    {
+      scratch.Lend(textureImages[i]);
+      payloadTasks.emplace_back([&, i] { detail::ParseTextureImageInto(document.textureImages[i], textureImages[i]); });
+    }
+
+    // One task per chunk; the calling thread runs tasks too. Pool threads time their
+    // stages into the collector of this parse.
+    detail::StatsCollector* const stats = detail::BoundStatsCollector();
+    detail::ParallelFor(payloadTasks.size(), 1, [&payloadTasks, stats](const std::size_t begin, const std::size_t end) {
+      const detail::StatsBinding binding(stats);
+      for (std::size_t task = begin; task < end; ++task)
+      {
+        payloadTasks[task]();
+      }
+    });
+
+    if (document.hasBinaryData)
+    {
+      detail::ReportVertexCount(m_Vertices.size(), NbVertices);
+      detail::ReportFacetCount(m_Triangles.size(), NbFaces, m_FacetDecodeInfo);
+    }
+
+    // Second wave: mapping the UV streams to triangle corners needs the facets,
+    // through one corner map shared by every set
+    if (textureCoordinates.empty())
+    {
+      return;
+    }
+    const std::size_t vertexCount = m_Vertices.size() / 3;
+    detail::BuildVertexCornerMap(m_Triangles, vertexCount, scratch.cornerMap);
+    detail::ParallelFor(textureCoordinates.size(), 1, [&](const std::size_t begin, const std::size_t end) {
+      const detail::StatsBinding binding(stats);
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        detail::DecodePerVertexTextureCoordinatesInto(uvStreams[i], vertexCount, m_Triangles.size(), scratch.cornerMap, textureCoordinates[i].cornerCoordinates);
+      }
+    });
+  }
+
+  bool DCMParser::ExportMesh(const fs::path& outputPath, const std::string& format, const ExportOptions& options) const
   {
+    const detail::ExportTimer exportTimer(m_Stats, format, outputPath);
     if (m_Vertices.empty() || m_Triangles.empty())
     {
-      fmt::print("Error: No mesh data to export\n");
+      O3SDCM_LOG_ERROR("No mesh data to export");
       return false;
     }
 
@@ -1447,44 +2802,72 @@ namespace Open3SDCM
           m_Triangles[i].v2 >= numVertices ||
           m_Triangles[i].v3 >= numVertices)
       {
-        fmt::print("Warning: Triangle {} has invalid indices: ({}, {}, {}), max vertex index: {}\n",
-                   i, m_Triangles[i].v1, m_Triangles[i].v2, m_Triangles[i].v3, numVertices - 1);
+        O3SDCM_LOG_WARN("Triangle {} has invalid indices: ({}, {}, {}), max vertex index: {}",
+                        i, m_Triangles[i].v1, m_Triangles[i].v2, m_Triangles[i].v3, numVertices - 1);
         invalidTriangles++;
       }
     }
 
     if (invalidTriangles > 0)
     {
-      fmt::print("Error: Found {} triangles with invalid indices. Cannot export.\n", invalidTriangles);
+      O3SDCM_LOG_ERROR("Found {} triangles with invalid indices. Cannot export.", invalidTriangles);
       return false;
     }
 
-    if (format == "ply")
+    if (format == "ply" || format == "plyb")
     {
-      const bool exported = detail::ExportPly(outputPath, m_Vertices, m_Triangles, m_SurfaceData);
+      const auto encoding = format == "plyb" ? detail::PlyEncoding::BinaryLittleEndian : detail::PlyEncoding::Ascii;
+      const bool exported = detail::ExportPly(outputPath, m_Vertices, m_Triangles, m_SurfaceData, encoding, options);
       if (!exported)
       {
-        fmt::print("Error: Failed to export mesh to PLY\n");
+        O3SDCM_LOG_ERROR("Failed to export mesh to PLY");
         return false;
       }
 
-      fmt::print("Successfully exported mesh to: {}\n", outputPath.string());
+      O3SDCM_LOG_DEBUG("Successfully exported mesh to: {}", outputPath.string());
       return true;
     }
 
     if (format == "obj")
     {
-      const bool exported = detail::ExportObj(outputPath, m_Vertices, m_Triangles, m_SurfaceData);
+      const bool exported = detail::ExportObj(outputPath, m_Vertices, m_Triangles, m_SurfaceData, options);
+      if (!exported)
+      {
+        O3SDCM_LOG_ERROR("Failed to export mesh to OBJ");
+        return false;
+      }
+
+      O3SDCM_LOG_DEBUG("Successfully exported mesh to: {}", outputPath.string());
+      return true;
+    }
+
+    if (format == "glb")
+    {
+      const bool exported = detail::ExportGlb(outputPath, m_Vertices, m_Triangles, m_SurfaceData);
+      if (!exported)
+      {
+        O3SDCM_LOG_ERROR("Failed to export mesh to GLB");
+        return false;
+      }
+
+      O3SDCM_LOG_DEBUG("Successfully exported mesh to: {}", outputPath.string());
+      return true;
+    }
+
+    if (format == "stlb")
+    {
+      const bool exported = detail::ExportBinaryStl(outputPath, m_Vertices, m_Triangles);
       if (!exported)
       {
-        fmt::print("Error: Failed to export mesh to OBJ\n");
+        O3SDCM_LOG_ERROR("Failed to export mesh to binary STL");
         return false;
       }
 
-      fmt::print("Successfully exported mesh to: {}\n", outputPath.string());
+      O3SDCM_LOG_DEBUG("Successfully exported mesh to: {}", outputPath.string());
       return true;
     }
 
+    // Formats without a native writer go through Assimp
     aiScene* scene = new aiScene();
     scene->mRootNode = new aiNode();
 
@@ -1524,7 +2907,6 @@ namespace Open3SDCM
 
     std::string formatId = format;
     if (format == "stl") formatId = "stl";
-    else if (format == "stlb") formatId = "stlb";
 
     Assimp::Exporter exporter;
     aiReturn result = exporter.Export(scene, formatId, outputPath.string(), 0);
@@ -1533,11 +2915,11 @@ namespace Open3SDCM
 
     if (result != AI_SUCCESS)
     {
-      fmt::print("Error: Failed to export mesh - {}\n", exporter.GetErrorString());
+      O3SDCM_LOG_ERROR("Failed to export mesh - {}", exporter.GetErrorString());
       return false;
     }
 
-    fmt::print("Successfully exported mesh to: {}\n", outputPath.string());
+    O3SDCM_LOG_DEBUG("Successfully exported mesh to: {}", outputPath.string());
     return true;
   }
 
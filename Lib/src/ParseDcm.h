@@ -6,9 +6,9 @@
 #include <vector>
 #include <filesystem>
 #include <map>
-
-#include <Poco/DOM/AutoPtr.h>
-#include <Poco/DOM/NodeList.h>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
 
 #include "definitions.h"
 
@@ -16,18 +16,71 @@ namespace fs = std::filesystem;
 
 namespace Open3SDCM
 {
+  namespace detail
+  {
+    struct DcmDocument;
+    struct DecodedMesh;
+    struct ParseScratch;
+  }
 
   class DCMParser
   {
   public:
-    void ParseDCM(const fs::path& filePath);
-    bool ExportMesh(const fs::path& outputPath, const std::string& format = "stl") const;
+    DCMParser();
+    // The scanned document of each parse (elements, attributes, properties: memory
+    // that only lives during the parse) is allocated from `documentResource`
+    // instead of the parser's own arena. It must outlive the parser.
+    explicit DCMParser(std::pmr::memory_resource* documentResource);
+    ~DCMParser();
+    // Not copyable: a parser owns the buffers it reuses from one parse to the next
+    DCMParser(DCMParser&&) noexcept;
+    DCMParser& operator=(DCMParser&&) noexcept;
+
+    void ParseDCM(const fs::path& filePath, const ParseOptions& options = {});
+    // Same as ParseDCM, on the content of a DCM file already in memory (e.g. prefetched
+    // by another thread). The buffer only needs to outlive the call.
+    void ParseDCMBuffer(std::string_view content, const ParseOptions& options = {});
+    // Same, for the content of `sourcePath`; goes through options.cacheDirectory if set
+    void ParseDCMBuffer(std::string_view content, const fs::path& sourcePath, const ParseOptions& options);
+    bool ExportMesh(const fs::path& outputPath, const std::string& format = "stl", const ExportOptions& options = {}) const;
+
+    // Decoded-mesh cache file of the parsed `sourcePath` (MeshCache.h). The source is
+    // hashed so that the entry is only ever loaded for the same content; both throw
+    // Poco::FileNotFoundException / Poco::ReadFileException if it cannot be read.
+    bool WriteCache(const fs::path& cachePath, const fs::path& sourcePath) const;
+    // Returns false, leaving the parser untouched, if the cache file is missing,
+    // damaged, or was written for another content of `sourcePath`
+    bool LoadCache(const fs::path& cachePath, const fs::path& sourcePath);
+
+    // Bytes of decode buffers kept for the next parse, not counting the result
+    // members below (ParseOptions::retainedBufferBudget)
+    std::size_t RetainedScratchBytes() const;
+    // Frees them, e.g. before keeping an idle parser around
+    void ReleaseScratch();
+    // Empties the result members, keeping their buffers for the next parse within
+    // options.retainedBufferBudget (ParseDCM starts with this; call it to trim an
+    // idle parser)
+    void ResetResult(const ParseOptions& options);
+    // Bytes of all buffers kept for the next parse once the result is reset: the
+    // decode buffers plus the capacity of m_Vertices and m_Triangles
+    std::size_t RetainedBufferBytes() const;
 
     std::vector<float> m_Vertices; //Buffer of vertices (x,y,z) contigous size/3 to get Nb of Vertices
     std::vector<Triangle> m_Triangles; //Buffer of triangles (indices)
     SurfaceData m_SurfaceData;
+    FacetDecodeInfo m_FacetDecodeInfo; //Index width chosen for the facet payload, and why
+    // Stage timings of the last parse when ParseOptions::collectStats was set, plus the
+    // ExportMesh calls made since (hence mutable; not to be exported from several threads)
+    mutable ParseStats m_Stats;
   private:
-    void ParseBinaryData(Poco::AutoPtr<Poco::XML::NodeList> BinaryNodes, const std::string& schema, const std::map<std::string, std::string>& properties);
+    void ParseBinaryData(const detail::DcmDocument& document);
+    // ParseBinaryData + ParseSurfaceData as a task graph (ParseOptions::concurrentDecode)
+    void ParseConcurrently(const detail::DcmDocument& document);
+    void AdoptDecodedMesh(detail::DecodedMesh&& mesh);
+    detail::ParseScratch& Scratch();
+
+    std::unique_ptr<detail::ParseScratch> m_Scratch;// created on first use
+    std::pmr::memory_resource* m_DocumentResource{nullptr};// null: the arena of m_Scratch
 
   }; // class DCMParser
 }// namespace Open3SDCM
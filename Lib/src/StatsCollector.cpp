@@ -0,0 +1,108 @@
+//
+// Per-stage timing of a parse (ParseOptions::collectStats), cheap enough to leave compiled in.
+//
+
+#include "StatsCollector.h"
+
+#include <iterator>
+
+namespace Open3SDCM::detail
+{
+  namespace
+  {
+    thread_local StatsCollector* t_BoundCollector = nullptr;
+
+    void ToTiming(const std::int64_t nanoseconds, const std::uint64_t bytes, const std::uint64_t calls, StageTiming& timing)
+    {
+      timing.seconds = static_cast<double>(nanoseconds) * 1e-9;
+      timing.bytes = bytes;
+      timing.calls = calls;
+    }
+  }// namespace
+
+  void StatsCollector::Record(const ParseStage stage, const std::chrono::steady_clock::duration elapsed, const std::uint64_t bytes)
+  {
+    Counters& counters = m_Stages[static_cast<std::size_t>(stage)];
+    counters.nanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), std::memory_order_relaxed);
+    counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    counters.calls.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void StatsCollector::RecordBuffer(const std::uint64_t bytes, const std::uint64_t allocations)
+  {
+    m_BufferAllocations.fetch_add(allocations, std::memory_order_relaxed);
+    m_BufferBytes.fetch_add(bytes, std::memory_order_relaxed);
+    std::uint64_t peak = m_PeakBufferBytes.load(std::memory_order_relaxed);
+    while (bytes > peak && !m_PeakBufferBytes.compare_exchange_weak(peak, bytes, std::memory_order_relaxed))
+    {
+    }
+  }
+
+  void StatsCollector::Snapshot(ParseStats& stats) const
+  {
+    StageTiming* const timings[] = {&stats.fileRead,
+                                    &stats.cacheLoad,
+                                    &stats.cacheStore,
+                                    &stats.xmlParse,
+                                    &stats.base64Decode,
+                                    &stats.decrypt,
+                                    &stats.checksum,
+                                    &stats.facetDecode,
+                                    &stats.uvDecode,
+                                    &stats.textureDecode};
+    static_assert(std::size(timings) == static_cast<std::size_t>(ParseStage::Count));
+    for (std::size_t stage = 0; stage < m_Stages.size(); ++stage)
+    {
+      const Counters& counters = m_Stages[stage];
+      ToTiming(counters.nanoseconds.load(), counters.bytes.load(), counters.calls.load(), *timings[stage]);
+    }
+    stats.bufferAllocations = m_BufferAllocations.load();
+    stats.bufferBytes = m_BufferBytes.load();
+    stats.peakBufferBytes = m_PeakBufferBytes.load();
+  }
+
+  StatsCollector* BoundStatsCollector()
+  {
+    return t_BoundCollector;
+  }
+
+  StatsBinding::StatsBinding(StatsCollector* collector) : m_Previous(t_BoundCollector)
+  {
+    t_BoundCollector = collector;
+  }
+
+  StatsBinding::~StatsBinding()
+  {
+    t_BoundCollector = m_Previous;
+  }
+
+  StatsSession::StatsSession(const bool enabled, ParseStats& target)
+  {
+    if (t_BoundCollector != nullptr)
+    {
+      return;
+    }
+
+    target = {};
+    if (enabled)
+    {
+      m_Target = &target;
+      m_Collector = std::make_unique<StatsCollector>();
+      m_Binding = std::make_unique<StatsBinding>(m_Collector.get());
+      m_Start = std::chrono::steady_clock::now();
+    }
+  }
+
+  StatsSession::~StatsSession()
+  {
+    if (m_Target == nullptr)
+    {
+      return;
+    }
+
+    m_Binding.reset();
+    m_Collector->Snapshot(*m_Target);
+    m_Target->totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_Start).count();
+    m_Target->collected = true;
+  }
+}// namespace Open3SDCM::detail
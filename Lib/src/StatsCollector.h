@@ -0,0 +1,136 @@
+//
+// Per-stage timing of a parse (ParseOptions::collectStats), cheap enough to leave compiled in.
+//
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "definitions.h"
+
+namespace Open3SDCM::detail
+{
+  enum class ParseStage : std::size_t
+  {
+    FileRead,
+    CacheLoad,
+    CacheStore,
+    XmlParse,
+    Base64Decode,
+    Decrypt,
+    Checksum,
+    FacetDecode,
+    UvDecode,
+    TextureDecode,
+    Count
+  };
+
+  // Totals of one parse; safe to feed from the tasks of a concurrent decode
+  class StatsCollector
+  {
+  public:
+    void Record(ParseStage stage, std::chrono::steady_clock::duration elapsed, std::uint64_t bytes);
+    // `bytes` sized in `allocations` buffers of one kind, counted as one buffer for the peak
+    void RecordBuffer(std::uint64_t bytes, std::uint64_t allocations = 1);
+    // Stage and buffer fields of `stats`
+    void Snapshot(ParseStats& stats) const;
+
+  private:
+    struct Counters
+    {
+      std::atomic<std::int64_t> nanoseconds{0};
+      std::atomic<std::uint64_t> bytes{0};
+      std::atomic<std::uint64_t> calls{0};
+    };
+
+    std::array<Counters, static_cast<std::size_t>(ParseStage::Count)> m_Stages;
+    std::atomic<std::uint64_t> m_BufferAllocations{0};
+    std::atomic<std::uint64_t> m_BufferBytes{0};
+    std::atomic<std::uint64_t> m_PeakBufferBytes{0};
+  };
+
+  // Collector of the parse running on this thread, null when stats are off
+  StatsCollector* BoundStatsCollector();
+
+  // Binds `collector` to this thread for the scope (e.g. inside a pool task), then
+  // restores the previous binding
+  class StatsBinding
+  {
+  public:
+    explicit StatsBinding(StatsCollector* collector);
+    ~StatsBinding();
+
+    StatsBinding(const StatsBinding&) = delete;
+    StatsBinding& operator=(const StatsBinding&) = delete;
+
+  private:
+    StatsCollector* m_Previous;
+  };
+
+  // Times its scope into a stage. Without a collector it does nothing, not even read the clock.
+  class StageTimer
+  {
+  public:
+    explicit StageTimer(ParseStage stage, std::uint64_t bytes = 0) : StageTimer(BoundStatsCollector(), stage, bytes) {}
+    StageTimer(StatsCollector* collector, ParseStage stage, std::uint64_t bytes = 0)
+      : m_Collector(collector), m_Stage(stage), m_Bytes(bytes)
+    {
+      if (m_Collector != nullptr)
+      {
+        m_Start = std::chrono::steady_clock::now();
+      }
+    }
+    ~StageTimer() { Stop(); }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+    void AddBytes(const std::uint64_t bytes) { m_Bytes += bytes; }
+
+    // Records now rather than at the end of the scope
+    void Stop()
+    {
+      if (m_Collector != nullptr)
+      {
+        m_Collector->Record(m_Stage, std::chrono::steady_clock::now() - m_Start, m_Bytes);
+        m_Collector = nullptr;
+      }
+    }
+
+  private:
+    StatsCollector* m_Collector;
+    ParseStage m_Stage;
+    std::uint64_t m_Bytes;
+    std::chrono::steady_clock::time_point m_Start;
+  };
+
+  inline void RecordBuffer(const std::uint64_t bytes, const std::uint64_t allocations = 1)
+  {
+    if (StatsCollector* collector = BoundStatsCollector())
+    {
+      collector->RecordBuffer(bytes, allocations);
+    }
+  }
+
+  // Resets `target` at the start of an outermost parse call and, if `enabled`, collects
+  // the call into it. Nested calls (ParseDCM -> ParseDCMBuffer) join the enclosing session.
+  class StatsSession
+  {
+  public:
+    StatsSession(bool enabled, ParseStats& target);
+    ~StatsSession();
+
+    StatsSession(const StatsSession&) = delete;
+    StatsSession& operator=(const StatsSession&) = delete;
+
+  private:
+    ParseStats* m_Target{nullptr};  // set when this session collects
+    std::unique_ptr<StatsCollector> m_Collector;
+    std::unique_ptr<StatsBinding> m_Binding;
+    std::chrono::steady_clock::time_point m_Start;
+  };
+}// namespace Open3SDCM::detail
@@ -0,0 +1,217 @@
+//
+// Fixed-size work-stealing pool shared by the parallel decode and export paths.
+//
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace Open3SDCM::detail
+{
+  namespace
+  {
+    // Identifies the pool worker running on this thread, if any
+    thread_local const void* t_CurrentPool = nullptr;
+    thread_local std::size_t t_WorkerIndex = 0;
+  }// namespace
+
+  ThreadPool::ThreadPool(std::size_t threadCount)
+  {
+    if (threadCount == 0)
+    {
+      threadCount = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    m_Queues.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i)
+    {
+      m_Queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    m_Workers.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i)
+    {
+      m_Workers.emplace_back([this, i] { WorkerLoop(i); });
+    }
+  }
+
+  ThreadPool::~ThreadPool()
+  {
+    {
+      std::lock_guard lock(m_WakeMutex);
+      m_Stopping = true;
+    }
+    m_Wakeup.notify_all();
+    for (auto& worker : m_Workers)
+    {
+      worker.join();
+    }
+  }
+
+  void ThreadPool::Submit(std::function<void()> task)
+  {
+    const std::size_t queueIndex = t_CurrentPool == this
+      ? t_WorkerIndex
+      : m_NextQueue.fetch_add(1, std::memory_order_relaxed) % m_Queues.size();
+    {
+      std::lock_guard lock(m_Queues[queueIndex]->mutex);
+      m_Queues[queueIndex]->tasks.push_back(std::move(task));
+    }
+    {
+      std::lock_guard lock(m_WakeMutex);
+      m_Pending.fetch_add(1);
+    }
+    m_Wakeup.notify_one();
+  }
+
+  ThreadPool& ThreadPool::Shared()
+  {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  bool ThreadPool::TryPop(const std::size_t workerIndex, std::function<void()>& task)
+  {
+    {
+      WorkQueue& own = *m_Queues[workerIndex];
+      std::lock_guard lock(own.mutex);
+      if (!own.tasks.empty())
+      {
+        task = std::move(own.tasks.back());
+        own.tasks.pop_back();
+        return true;
+      }
+    }
+
+    for (std::size_t offset = 1; offset < m_Queues.size(); ++offset)
+    {
+      WorkQueue& victim = *m_Queues[(workerIndex + offset) % m_Queues.size()];
+      std::lock_guard lock(victim.mutex);
+      if (!victim.tasks.empty())
+      {
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void ThreadPool::WorkerLoop(const std::size_t workerIndex)
+  {
+    t_CurrentPool = this;
+    t_WorkerIndex = workerIndex;
+
+    for (;;)
+    {
+      std::function<void()> task;
+      if (TryPop(workerIndex, task))
+      {
+        m_Pending.fetch_sub(1);
+        task();
+        continue;
+      }
+
+      std::unique_lock lock(m_WakeMutex);
+      m_Wakeup.wait(lock, [this] { return m_Stopping || m_Pending.load() > 0; });
+      if (m_Stopping && m_Pending.load() == 0)
+      {
+        return;// stopping and drained
+      }
+    }
+  }
+
+  namespace
+  {
+    // Shared with the helper tasks, which may only get to run after the loop is over
+    struct ParallelForState
+    {
+      std::size_t count{0};
+      std::size_t grain{1};
+      std::size_t chunkCount{0};
+      const std::function<void(std::size_t, std::size_t)>* body{nullptr};
+
+      std::atomic<std::size_t> nextChunk{0};
+      std::atomic<std::size_t> finishedChunks{0};
+      std::atomic<bool> failed{false};
+      std::exception_ptr error;
+
+      std::mutex mutex;
+      std::condition_variable done;
+
+      void RunChunks()
+      {
+        for (std::size_t chunk = nextChunk.fetch_add(1); chunk < chunkCount; chunk = nextChunk.fetch_add(1))
+        {
+          if (!failed.load(std::memory_order_relaxed))
+          {
+            const std::size_t begin = chunk * grain;
+            try
+            {
+              (*body)(begin, std::min(count, begin + grain));
+            }
+            catch (...)
+            {
+              std::lock_guard lock(mutex);
+              if (!failed.exchange(true))
+              {
+                error = std::current_exception();
+              }
+            }
+          }
+
+          if (finishedChunks.fetch_add(1) + 1 == chunkCount)
+          {
+            std::lock_guard lock(mutex);
+            done.notify_all();
+          }
+        }
+      }
+    };
+  }// namespace
+
+  void ParallelFor(const std::size_t count,
+                   std::size_t grain,
+                   const std::function<void(std::size_t begin, std::size_t end)>& body,
+                   ThreadPool& pool)
+  {
+    if (count == 0)
+    {
+      return;
+    }
+
+    grain = std::max<std::size_t>(grain, 1);
+    const std::size_t chunkCount = (count + grain - 1) / grain;
+    if (chunkCount == 1 || pool.Size() == 0)
+    {
+      body(0, count);
+      return;
+    }
+
+    auto state = std::make_shared<ParallelForState>();
+    state->count = count;
+    state->grain = grain;
+    state->chunkCount = chunkCount;
+    state->body = &body;
+
+    const std::size_t helperCount = std::min(pool.Size(), chunkCount - 1);
+    for (std::size_t i = 0; i < helperCount; ++i)
+    {
+      pool.Submit([state] { state->RunChunks(); });
+    }
+    state->RunChunks();
+
+    {
+      std::unique_lock lock(state->mutex);
+      state->done.wait(lock, [&] { return state->finishedChunks.load() == chunkCount; });
+    }
+
+    if (state->error)
+    {
+      std::rethrow_exception(state->error);
+    }
+  }
+}// namespace Open3SDCM::detail
@@ -0,0 +1,71 @@
+//
+// Fixed-size work-stealing pool shared by the parallel decode and export paths.
+//
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Open3SDCM::detail
+{
+  // Every worker owns a deque. Tasks submitted from a worker go to the back of
+  // its own deque and are taken back LIFO (cache-warm, e.g. nested ParallelFor
+  // helpers); tasks submitted from outside are spread round-robin. A worker
+  // whose deque is empty steals from the front of the others' before sleeping.
+  class ThreadPool
+  {
+  public:
+    // 0 picks std::thread::hardware_concurrency()
+    explicit ThreadPool(std::size_t threadCount = 0);
+    // Runs the tasks still queued, then joins the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    [[nodiscard]] std::size_t Size() const { return m_Workers.size(); }
+
+    // Queues a task; tasks must not throw
+    void Submit(std::function<void()> task);
+
+    // Process-wide pool, created on first use
+    static ThreadPool& Shared();
+
+  private:
+    struct WorkQueue
+    {
+      std::mutex mutex;
+      std::deque<std::function<void()>> tasks;
+    };
+
+    void WorkerLoop(std::size_t workerIndex);
+    bool TryPop(std::size_t workerIndex, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<WorkQueue>> m_Queues;
+    std::vector<std::thread> m_Workers;
+    std::atomic<std::size_t> m_NextQueue{0};
+
+    // Number of queued tasks; raised under m_WakeMutex so sleepers cannot miss it.
+    // Signed: a task can be popped just before its Submit raises the count.
+    std::atomic<std::ptrdiff_t> m_Pending{0};
+    std::mutex m_WakeMutex;
+    std::condition_variable m_Wakeup;
+    bool m_Stopping{false};
+  };
+
+  // Runs body(begin, end) over [0, count) split into chunks of `grain` items.
+  // The calling thread takes chunks too, so nested calls from pool workers
+  // cannot deadlock. Returns once every chunk is done; the first exception
+  // thrown by `body` is rethrown here.
+  void ParallelFor(std::size_t count,
+                   std::size_t grain,
+                   const std::function<void(std::size_t begin, std::size_t end)>& body,
+                   ThreadPool& pool = ThreadPool::Shared());
+}// namespace Open3SDCM::detail
@@ -0,0 +1,411 @@
+//
+// Forward-only XML tokenizer used to scan HPS documents without building a DOM.
+//
+
+#include "XmlPullParser.h"
+
+#include <charconv>
+#include <cstdint>
+
+#include <Poco/XML/XMLException.h>
+#include <fmt/format.h>
+
+namespace Open3SDCM::detail
+{
+  namespace
+  {
+    bool IsXmlWhitespace(const char c)
+    {
+      return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    bool IsNameTerminator(const char c)
+    {
+      return IsXmlWhitespace(c) || c == '/' || c == '>' || c == '=' || c == '<';
+    }
+
+    template <typename String>
+    void AppendUtf8(String& output, const std::uint32_t codePoint)
+    {
+      if (codePoint < 0x80U)
+      {
+        output.push_back(static_cast<char>(codePoint));
+      }
+      else if (codePoint < 0x800U)
+      {
+        output.push_back(static_cast<char>(0xC0U | (codePoint >> 6U)));
+        output.push_back(static_cast<char>(0x80U | (codePoint & 0x3FU)));
+      }
+      else if (codePoint < 0x10000U)
+      {
+        output.push_back(static_cast<char>(0xE0U | (codePoint >> 12U)));
+        output.push_back(static_cast<char>(0x80U | ((codePoint >> 6U) & 0x3FU)));
+        output.push_back(static_cast<char>(0x80U | (codePoint & 0x3FU)));
+      }
+      else
+      {
+        output.push_back(static_cast<char>(0xF0U | (codePoint >> 18U)));
+        output.push_back(static_cast<char>(0x80U | ((codePoint >> 12U) & 0x3FU)));
+        output.push_back(static_cast<char>(0x80U | ((codePoint >> 6U) & 0x3FU)));
+        output.push_back(static_cast<char>(0x80U | (codePoint & 0x3FU)));
+      }
+    }
+
+    // Expands references and normalizes line breaks of `raw` onto `output`
+    template <typename String>
+    void AppendDecoded(std::string_view raw, const bool isAttributeValue, String& output)
+    {
+      if (output.empty())
+      {
+        output.reserve(raw.size());
+      }
+
+      for (std::size_t i = 0; i < raw.size(); ++i)
+      {
+        const char c = raw[i];
+        if (c == '\r')
+        {
+          // CRLF and lone CR both become a single line feed
+          if (i + 1 < raw.size() && raw[i + 1] == '\n')
+          {
+            ++i;
+          }
+          output.push_back(isAttributeValue ? ' ' : '\n');
+          continue;
+        }
+        if (isAttributeValue && (c == '\n' || c == '\t'))
+        {
+          output.push_back(' ');
+          continue;
+        }
+        if (c != '&')
+        {
+          output.push_back(c);
+          continue;
+        }
+
+        const auto semicolon = raw.find(';', i + 1);
+        if (semicolon == std::string_view::npos)
+        {
+          throw Poco::XML::XMLException(fmt::format("Unterminated entity reference in '{}'", raw));
+        }
+        const std::string_view entity = raw.substr(i + 1, semicolon - i - 1);
+        i = semicolon;
+
+        if (entity == "amp") output.push_back('&');
+        else if (entity == "lt") output.push_back('<');
+        else if (entity == "gt") output.push_back('>');
+        else if (entity == "quot") output.push_back('"');
+        else if (entity == "apos") output.push_back('\'');
+        else if (entity.size() > 1 && entity[0] == '#')
+        {
+          const bool hex = entity[1] == 'x';
+          const std::string_view digits = entity.substr(hex ? 2 : 1);
+          std::uint32_t codePoint = 0;
+          const auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), codePoint, hex ? 16 : 10);
+          if (ec != std::errc() || ptr != digits.data() + digits.size() || digits.empty())
+          {
+            throw Poco::XML::XMLException(fmt::format("Invalid character reference &{};", entity));
+          }
+          AppendUtf8(output, codePoint);
+        }
+        else
+        {
+          throw Poco::XML::XMLException(fmt::format("Undefined entity &{};", entity));
+        }
+      }
+    }
+  }// namespace
+
+  XmlPullParser::XmlPullParser(std::string_view document, std::pmr::memory_resource* resource)
+    : m_Source(document), m_Attributes(resource), m_OpenElements(resource)
+  {
+    // Skip a UTF-8 byte order mark
+    if (m_Source.starts_with("\xEF\xBB\xBF"))
+    {
+      m_Offset = 3;
+    }
+  }
+
+  void XmlPullParser::Fail(std::string_view reason) const
+  {
+    throw Poco::XML::XMLException(fmt::format("{} at offset {}", reason, m_Offset));
+  }
+
+  void XmlPullParser::SkipPast(std::string_view terminator, std::string_view construct)
+  {
+    const auto end = m_Source.find(terminator, m_Offset);
+    if (end == std::string_view::npos)
+    {
+      Fail(fmt::format("Unterminated {}", construct));
+    }
+    m_Offset = end + terminator.size();
+  }
+
+  void XmlPullParser::SkipDoctype()
+  {
+    // <!DOCTYPE ... [ internal subset ] >
+    bool inSubset = false;
+    char quote = 0;
+    for (; m_Offset < m_Source.size(); ++m_Offset)
+    {
+      const char c = m_Source[m_Offset];
+      if (quote != 0)
+      {
+        if (c == quote) quote = 0;
+        continue;
+      }
+      if (c == '"' || c == '\'') quote = c;
+      else if (c == '[') inSubset = true;
+      else if (c == ']') inSubset = false;
+      else if (c == '>' && !inSubset)
+      {
+        ++m_Offset;
+        return;
+      }
+    }
+    Fail("Unterminated DOCTYPE declaration");
+  }
+
+  std::string_view XmlPullParser::ReadName()
+  {
+    const std::size_t start = m_Offset;
+    while (m_Offset < m_Source.size() && !IsNameTerminator(m_Source[m_Offset]))
+    {
+      ++m_Offset;
+    }
+    if (m_Offset == start)
+    {
+      Fail("Expected a name");
+    }
+    return m_Source.substr(start, m_Offset - start);
+  }
+
+  void XmlPullParser::SkipWhitespace()
+  {
+    while (m_Offset < m_Source.size() && IsXmlWhitespace(m_Source[m_Offset]))
+    {
+      ++m_Offset;
+    }
+  }
+
+  void XmlPullParser::ParseStartTag()
+  {
+    // m_Offset points just after '<'
+    if (m_SeenDocumentElement && m_OpenElements.empty())
+    {
+      Fail("Content after the document element");
+    }
+
+    m_Name = ReadName();
+    m_Attributes.clear();
+
+    while (true)
+    {
+      SkipWhitespace();
+      if (m_Offset >= m_Source.size())
+      {
+        Fail(fmt::format("Unterminated start tag <{}>", m_Name));
+      }
+
+      const char c = m_Source[m_Offset];
+      if (c == '>')
+      {
+        ++m_Offset;
+        m_PendingEmptyElementEnd = false;
+        break;
+      }
+      if (c == '/')
+      {
+        if (m_Offset + 1 >= m_Source.size() || m_Source[m_Offset + 1] != '>')
+        {
+          Fail(fmt::format("Malformed empty element <{}>", m_Name));
+        }
+        m_Offset += 2;
+        m_PendingEmptyElementEnd = true;
+        break;
+      }
+
+      Attribute attribute;
+      attribute.name = ReadName();
+      SkipWhitespace();
+      if (m_Offset >= m_Source.size() || m_Source[m_Offset] != '=')
+      {
+        Fail(fmt::format("Expected '=' after attribute {}", attribute.name));
+      }
+      ++m_Offset;
+      SkipWhitespace();
+      if (m_Offset >= m_Source.size() || (m_Source[m_Offset] != '"' && m_Source[m_Offset] != '\''))
+      {
+        Fail(fmt::format("Expected a quoted value for attribute {}", attribute.name));
+      }
+      const char quote = m_Source[m_Offset++];
+      const auto valueEnd = m_Source.find(quote, m_Offset);
+      if (valueEnd == std::string_view::npos)
+      {
+        Fail(fmt::format("Unterminated value for attribute {}", attribute.name));
+      }
+      attribute.rawValue = m_Source.substr(m_Offset, valueEnd - m_Offset);
+      m_Offset = valueEnd + 1;
+      m_Attributes.push_back(attribute);
+    }
+
+    m_SeenDocumentElement = true;
+    m_OpenElements.push_back(m_Name);
+    m_Event = Event::StartElement;
+  }
+
+  void XmlPullParser::ParseEndTag()
+  {
+    // m_Offset points just after "</"
+    m_Name = ReadName();
+    SkipWhitespace();
+    if (m_Offset >= m_Source.size() || m_Source[m_Offset] != '>')
+    {
+      Fail(fmt::format("Malformed end tag </{}>", m_Name));
+    }
+    ++m_Offset;
+
+    if (m_OpenElements.empty() || m_OpenElements.back() != m_Name)
+    {
+      Fail(fmt::format("Mismatched end tag </{}>", m_Name));
+    }
+    m_OpenElements.pop_back();
+    m_Attributes.clear();
+    m_Event = Event::EndElement;
+  }
+
+  XmlPullParser::Event XmlPullParser::Next()
+  {
+    if (m_PendingEmptyElementEnd)
+    {
+      m_PendingEmptyElementEnd = false;
+      m_OpenElements.pop_back();
+      m_Attributes.clear();
+      m_Event = Event::EndElement;
+      return m_Event;
+    }
+
+    while (m_Offset < m_Source.size())
+    {
+      if (m_Source[m_Offset] != '<')
+      {
+        const auto markup = m_Source.find('<', m_Offset);
+        const std::size_t end = markup == std::string_view::npos ? m_Source.size() : markup;
+        const std::string_view text = m_Source.substr(m_Offset, end - m_Offset);
+        m_Offset = end;
+
+        // Character data is only reported inside the document element
+        if (m_OpenElements.empty())
+        {
+          continue;
+        }
+
+        m_Text = text;
+        m_TextNeedsDecoding = text.find_first_of("&\r") != std::string_view::npos;
+        m_Event = Event::Text;
+        return m_Event;
+      }
+
+      const std::string_view rest = m_Source.substr(m_Offset);
+      if (rest.starts_with("<!--"))
+      {
+        m_Offset += 4;
+        SkipPast("-->", "comment");
+      }
+      else if (rest.starts_with("<![CDATA["))
+      {
+        m_Offset += 9;
+        const auto end = m_Source.find("]]>", m_Offset);
+        if (end == std::string_view::npos)
+        {
+          Fail("Unterminated CDATA section");
+        }
+        m_Text = m_Source.substr(m_Offset, end - m_Offset);
+        m_TextNeedsDecoding = false;
+        m_Offset = end + 3;
+        if (m_OpenElements.empty())
+        {
+          Fail("CDATA section outside the document element");
+        }
+        m_Event = Event::Text;
+        return m_Event;
+      }
+      else if (rest.starts_with("<!DOCTYPE"))
+      {
+        m_Offset += 9;
+        SkipDoctype();
+      }
+      else if (rest.starts_with("<?"))
+      {
+        m_Offset += 2;
+        SkipPast("?>", "processing instruction");
+      }
+      else if (rest.starts_with("</"))
+      {
+        m_Offset += 2;
+        ParseEndTag();
+        return m_Event;
+      }
+      else
+      {
+        ++m_Offset;
+        ParseStartTag();
+        return m_Event;
+      }
+    }
+
+    if (!m_OpenElements.empty())
+    {
+      Fail(fmt::format("Unexpected end of document inside <{}>", m_OpenElements.back()));
+    }
+    if (!m_SeenDocumentElement)
+    {
+      Fail("No document element");
+    }
+    m_Event = Event::EndDocument;
+    return m_Event;
+  }
+
+  std::optional<std::string> XmlPullParser::GetAttribute(std::string_view name) const
+  {
+    if (const auto rawValue = GetRawAttribute(name))
+    {
+      return DecodeCharacterData(*rawValue, true);
+    }
+    return std::nullopt;
+  }
+
+  std::optional<std::string_view> XmlPullParser::GetRawAttribute(std::string_view name) const
+  {
+    for (const auto& attribute : m_Attributes)
+    {
+      if (attribute.name == name)
+      {
+        return attribute.rawValue;
+      }
+    }
+    return std::nullopt;
+  }
+
+  std::string XmlPullParser::DecodedText() const
+  {
+    if (!m_TextNeedsDecoding)
+    {
+      return std::string(m_Text);
+    }
+    return DecodeCharacterData(m_Text, false);
+  }
+
+  std::string XmlPullParser::DecodeCharacterData(std::string_view raw, const bool isAttributeValue)
+  {
+    std::string output;
+    AppendDecoded(raw, isAttributeValue, output);
+    return output;
+  }
+
+  void XmlPullParser::AppendCharacterData(std::string_view raw, const bool isAttributeValue, std::pmr::string& output)
+  {
+    AppendDecoded(raw, isAttributeValue, output);
+  }
+}// namespace Open3SDCM::detail
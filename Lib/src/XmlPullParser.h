@@ -0,0 +1,85 @@
+//
+// Forward-only XML tokenizer used to scan HPS documents without building a DOM.
+//
+
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Open3SDCM::detail
+{
+  // Pull tokenizer over an in-memory XML document.
+  // Names, attribute values and text are returned as views into the source buffer,
+  // so the buffer must outlive the parser and every view obtained from it. Its own
+  // element stack and attribute list allocate from the given resource.
+  // Comments, processing instructions and DOCTYPE declarations are skipped.
+  // Malformed markup raises Poco::XML::XMLException.
+  class XmlPullParser
+  {
+  public:
+    enum class Event
+    {
+      StartElement,
+      EndElement,
+      Text,
+      EndDocument
+    };
+
+    struct Attribute
+    {
+      std::string_view name;
+      std::string_view rawValue;// value as written, entities not expanded
+    };
+
+    explicit XmlPullParser(std::string_view document, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    Event Next();
+
+    // Element name of the current StartElement / EndElement event
+    [[nodiscard]] std::string_view Name() const { return m_Name; }
+    // Depth of the current element, the document element being at depth 1
+    [[nodiscard]] std::size_t Depth() const { return m_OpenElements.size() + (m_Event == Event::EndElement ? 1U : 0U); }
+    [[nodiscard]] const std::pmr::vector<Attribute>& Attributes() const { return m_Attributes; }
+    [[nodiscard]] std::optional<std::string> GetAttribute(std::string_view name) const;
+    // Value as written, entities not expanded
+    [[nodiscard]] std::optional<std::string_view> GetRawAttribute(std::string_view name) const;
+
+    // Raw character data of the current Text event
+    [[nodiscard]] std::string_view RawText() const { return m_Text; }
+    // True when RawText() contains references or line breaks that need normalizing
+    [[nodiscard]] bool TextNeedsDecoding() const { return m_TextNeedsDecoding; }
+    // Character data of the current Text event with references expanded
+    [[nodiscard]] std::string DecodedText() const;
+
+    // Expands the predefined entities and character references and normalizes line breaks.
+    // Attribute values additionally get their whitespace characters replaced by spaces.
+    static std::string DecodeCharacterData(std::string_view raw, bool isAttributeValue);
+    // Same, appended to `output`
+    static void AppendCharacterData(std::string_view raw, bool isAttributeValue, std::pmr::string& output);
+
+  private:
+    [[noreturn]] void Fail(std::string_view reason) const;
+    void SkipPast(std::string_view terminator, std::string_view construct);
+    void SkipDoctype();
+    std::string_view ReadName();
+    void SkipWhitespace();
+    void ParseStartTag();
+    void ParseEndTag();
+
+    std::string_view m_Source;
+    std::size_t m_Offset{0};
+
+    Event m_Event{Event::EndDocument};
+    std::string_view m_Name;
+    std::pmr::vector<Attribute> m_Attributes;
+    std::string_view m_Text;
+    bool m_TextNeedsDecoding{false};
+    bool m_PendingEmptyElementEnd{false};
+    bool m_SeenDocumentElement{false};
+    std::pmr::vector<std::string_view> m_OpenElements;
+  };
+}// namespace Open3SDCM::detail
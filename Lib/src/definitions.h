@@ -2,8 +2,12 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <filesystem>
+#include <map>
 #include <optional>
+#include <span>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace Open3SDCM
@@ -30,11 +34,136 @@ namespace Open3SDCM
     const float& operator[](int index) const { return data[index]; }
   };
 
-  struct Triangle
+  template <typename IndexT>
+  struct BasicTriangle
   {
-    size_t v1{0};
-    size_t v2{0};
-    size_t v3{0};
+    static_assert(std::is_unsigned_v<IndexT>, "vertex indices are unsigned");
+    using index_type = IndexT;
+
+    IndexT v1{0};
+    IndexT v2{0};
+    IndexT v3{0};
+  };
+
+  // The facet decoder only produces 16- and 32-bit indices, so triangles are
+  // 12 bytes and a triangle list doubles as a GPU-style uint32 index buffer.
+  using Triangle = BasicTriangle<std::uint32_t>;
+  // For consumers that want pointer-sized indices
+  using WideTriangle = BasicTriangle<std::size_t>;
+
+  static_assert(sizeof(Triangle) == 3 * sizeof(std::uint32_t) && std::is_standard_layout_v<Triangle>);
+
+  // Flat v1, v2, v3, v1, ... view of a triangle list (glDrawElements / vertex buffer index data)
+  inline std::span<const std::uint32_t> AsIndexBuffer(const std::vector<Triangle>& triangles)
+  {
+    return {reinterpret_cast<const std::uint32_t*>(triangles.data()), triangles.size() * 3};
+  }
+
+  template <typename ToIndexT, typename FromIndexT>
+  std::vector<BasicTriangle<ToIndexT>> ConvertTriangles(const std::vector<BasicTriangle<FromIndexT>>& triangles)
+  {
+    std::vector<BasicTriangle<ToIndexT>> converted;
+    converted.reserve(triangles.size());
+    for (const auto& triangle : triangles)
+    {
+      converted.push_back({static_cast<ToIndexT>(triangle.v1), static_cast<ToIndexT>(triangle.v2), static_cast<ToIndexT>(triangle.v3)});
+    }
+    return converted;
+  }
+
+  // Width of the vertex indices carried by the facet opcodes 5 (RESTART_16)
+  // and 7 (ABSOLUTE_16); the HPS data does not state it explicitly.
+  enum class FacetIndexWidth
+  {
+    Bits16,
+    Bits32
+  };
+
+  // Why InterpretFacetsBuffer picked a FacetIndexWidth
+  enum class FacetWidthReason
+  {
+    NotDecoded,         // no facet payload
+    WidthIndependent,   // the stream has no opcode 5 or 7, both widths decode the same
+    FaceCountMatch,     // only this width yields facet_count faces
+    BothMatch,          // both widths yield facet_count faces, 16-bit preferred
+    NoWidthMatches,     // no width yields facet_count faces, the 32-bit decode was kept
+    PrescanMismatch     // the prescan's pick did not decode to facet_count, the other width did
+  };
+
+  struct FacetDecodeInfo
+  {
+    FacetIndexWidth width{FacetIndexWidth::Bits16};
+    FacetWidthReason reason{FacetWidthReason::NotDecoded};
+    std::size_t expectedFaceCount{0};
+    std::size_t prescanFaceCount16{0};
+    std::size_t prescanFaceCount32{0};
+    std::size_t decodedFaceCount{0};
+    std::size_t decodePasses{0};
+  };
+
+  // Output settings shared by the exporters
+  struct ExportOptions
+  {
+    // Significant digits of the floats written by the text formats (OBJ, ASCII PLY),
+    // as printf's %g. 0 writes the shortest text that reads back to the same float.
+    int floatPrecision{0};
+    // OBJ: write each distinct texture coordinate once and index it from the faces,
+    // instead of one "vt" line per triangle corner
+    bool deduplicateTextureCoordinates{false};
+  };
+
+  // How DCMParser schedules the work for one file
+  struct ParseOptions
+  {
+    // Decode the vertices, the facets, the texture images and the UV streams as
+    // concurrent tasks on the shared thread pool, instead of one after another.
+    // The results are the same; it cuts the latency of a single large file.
+    // Leave it off when files are already converted in parallel.
+    bool concurrentDecode{false};
+    // Directory of decoded-mesh cache entries (MeshCache.h); empty disables the cache.
+    // ParseDCM loads the entry of an unchanged file instead of decoding it, and
+    // stores one after decoding a new or modified file.
+    std::filesystem::path cacheDirectory;
+    // Time every decode stage into DCMParser::m_Stats. Off by default: the stages
+    // then do not even read the clock.
+    bool collectStats{false};
+    // A DCMParser keeps its decode buffers and the capacity of its previous result,
+    // so that parsing file after file with one parser stops allocating. Past this
+    // many bytes it frees the largest of them before and after each parse; 0 keeps
+    // them all.
+    std::size_t retainedBufferBudget{0};
+  };
+
+  // Time and volume of one parse stage, summed over its calls
+  struct StageTiming
+  {
+    double seconds{0.0};     // concurrent calls add up, so stages can exceed the total
+    std::uint64_t bytes{0};  // data handled: decoded bytes for the decoders, file size for I/O
+    std::uint64_t calls{0};  // timed sections (the streamed CE decoders time every 4 KB block)
+  };
+
+  // Where one parse spent its time (ParseOptions::collectStats). The stages are
+  // disjoint: a UV stream counts as base64 + decrypt + uvDecode, a texture as textureDecode.
+  struct ParseStats
+  {
+    bool collected{false};
+    double totalSeconds{0.0};
+    StageTiming fileRead;
+    StageTiming cacheLoad;   // hashing the source and reading its cache entry
+    StageTiming cacheStore;
+    StageTiming xmlParse;
+    StageTiming base64Decode;
+    StageTiming decrypt;
+    StageTiming checksum;
+    StageTiming facetDecode;
+    StageTiming uvDecode;
+    StageTiming textureDecode;
+    // ExportMesh calls made after the parse, by format; bytes is the output file size
+    std::map<std::string, StageTiming> exports;
+    // Large buffers the decoders sized (payloads, vertices, triangles, UV corners)
+    std::uint64_t bufferAllocations{0};
+    std::uint64_t bufferBytes{0};
+    std::uint64_t peakBufferBytes{0};  // largest single buffer
   };
 
   struct ColorRGB
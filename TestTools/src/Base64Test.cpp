@@ -0,0 +1,252 @@
+// Base64 decoder kernels against the scalar decoder.
+// Every vector kernel the running CPU supports decodes the same inputs as
+// Isa::Scalar, verifying:
+//   - identical bytes and return values for every input length and padding
+//   - whitespace skipped at every offset around the 16/32/64-character blocks
+//   - Poco::DataFormatException for characters outside the alphabet
+//   - no write past maxBytes + kOutputSlack, also for chunked StreamDecoder reads
+
+#define BOOST_TEST_MODULE Base64DecodeTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "Base64.h"
+
+#include <Poco/Exception.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace base64 = Open3SDCM::detail::base64;
+
+static constexpr std::array<base64::Isa, 3> k_VectorIsas = {base64::Isa::Sse41, base64::Isa::Avx2, base64::Isa::Neon};
+
+// Bytes past the slack the decoder may write; they must keep this value
+static constexpr std::size_t k_GuardSize = 64;
+static constexpr std::uint8_t k_GuardByte = 0xA5;
+
+// Longest decoded input: three 64-character blocks (the widest kernel step) and a partial quantum
+static constexpr std::size_t k_MaxDecodedLength = 3 * 64 + 3;
+
+static std::vector<std::uint8_t> randomBytes(const std::size_t size, const unsigned seed)
+{
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<int> byte(0, 255);
+  std::vector<std::uint8_t> bytes(size);
+  std::generate(bytes.begin(), bytes.end(), [&] { return static_cast<std::uint8_t>(byte(generator)); });
+  return bytes;
+}
+
+static std::string encode(const std::vector<std::uint8_t>& bytes)
+{
+  static constexpr std::string_view alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string encoded;
+  for (std::size_t i = 0; i < bytes.size(); i += 3)
+  {
+    const std::size_t count = std::min<std::size_t>(3, bytes.size() - i);
+    std::uint32_t bits = static_cast<std::uint32_t>(bytes[i]) << 16U;
+    if (count > 1)
+    {
+      bits |= static_cast<std::uint32_t>(bytes[i + 1]) << 8U;
+    }
+    if (count > 2)
+    {
+      bits |= bytes[i + 2];
+    }
+    for (std::size_t symbol = 0; symbol < 4; ++symbol)
+    {
+      encoded.push_back(symbol <= count ? alphabet[(bits >> (18U - 6U * symbol)) & 0x3FU] : '=');
+    }
+  }
+  return encoded;
+}
+
+struct DecodeResult
+{
+  std::size_t size = 0;
+  std::vector<std::uint8_t> bytes;
+  bool guardIntact = true;
+};
+
+// One-shot Decode into a buffer of exactly MaxDecodedSize + kOutputSlack bytes,
+// followed by a guard zone
+static DecodeResult decode(const std::string_view encoded, const base64::Isa isa)
+{
+  const std::size_t capacity = base64::MaxDecodedSize(encoded.size()) + base64::kOutputSlack;
+  std::vector<std::uint8_t> buffer(capacity + k_GuardSize, k_GuardByte);
+
+  DecodeResult result;
+  result.size = base64::Decode(encoded, buffer.data(), isa);
+  result.bytes.assign(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(std::min(result.size, capacity)));
+  result.guardIntact = std::all_of(buffer.begin() + static_cast<std::ptrdiff_t>(capacity), buffer.end(),
+                                   [](const std::uint8_t value) { return value == k_GuardByte; });
+  return result;
+}
+
+// StreamDecoder::Read in chunks of `chunkSize`, each into its own buffer of
+// chunkSize + kOutputSlack bytes followed by a guard zone
+static DecodeResult decodeChunked(const std::string_view encoded, const base64::Isa isa, const std::size_t chunkSize)
+{
+  base64::StreamDecoder decoder(encoded, isa);
+  DecodeResult result;
+  while (true)
+  {
+    std::vector<std::uint8_t> buffer(chunkSize + base64::kOutputSlack + k_GuardSize, k_GuardByte);
+    const std::size_t read = decoder.Read(buffer.data(), chunkSize);
+    result.guardIntact = result.guardIntact &&
+      std::all_of(buffer.begin() + static_cast<std::ptrdiff_t>(chunkSize + base64::kOutputSlack), buffer.end(),
+                  [](const std::uint8_t value) { return value == k_GuardByte; });
+    if (read > chunkSize)
+    {
+      result.guardIntact = false;
+      break;
+    }
+    result.bytes.insert(result.bytes.end(), buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(read));
+    result.size += read;
+    if (read < chunkSize / 3 * 3)
+    {
+      break;
+    }
+  }
+  return result;
+}
+
+template<typename Check>
+static void forEachSupportedIsa(Check check)
+{
+  for (const base64::Isa isa : k_VectorIsas)
+  {
+    if (!base64::IsSupported(isa))
+    {
+      BOOST_TEST_MESSAGE("Skipping " << base64::IsaName(isa) << ": not supported on this CPU");
+      continue;
+    }
+    BOOST_TEST_CONTEXT("isa " << base64::IsaName(isa))
+    {
+      check(isa);
+    }
+  }
+}
+
+static void checkMatchesScalar(const std::string_view encoded, const base64::Isa isa)
+{
+  const DecodeResult expected = decode(encoded, base64::Isa::Scalar);
+  const DecodeResult actual = decode(encoded, isa);
+  BOOST_REQUIRE_MESSAGE(actual.size == expected.size && actual.bytes == expected.bytes,
+    base64::IsaName(isa) << " differs from scalar for input of " << encoded.size() << " characters");
+  BOOST_REQUIRE_MESSAGE(expected.guardIntact && actual.guardIntact,
+    "Write past MaxDecodedSize + kOutputSlack for input of " << encoded.size() << " characters");
+}
+
+BOOST_AUTO_TEST_SUITE(Base64)
+
+// Padded encodings of 0 .. k_MaxDecodedLength bytes, so both one and two '='
+// characters, plus every prefix of the longest one (unpadded, partial quanta)
+BOOST_AUTO_TEST_CASE(EveryLengthMatchesScalar)
+{
+  forEachSupportedIsa([](const base64::Isa isa) {
+    for (std::size_t length = 0; length <= k_MaxDecodedLength; ++length)
+    {
+      const std::vector<std::uint8_t> bytes = randomBytes(length, static_cast<unsigned>(length));
+      const std::string encoded = encode(bytes);
+      checkMatchesScalar(encoded, isa);
+
+      const DecodeResult actual = decode(encoded, isa);
+      BOOST_REQUIRE_EQUAL(actual.size, length);
+      BOOST_REQUIRE(actual.bytes == bytes);
+    }
+
+    const std::string longest = encode(randomBytes(k_MaxDecodedLength + 1, 7U));
+    BOOST_REQUIRE_EQUAL(longest.back(), '=');
+    BOOST_REQUIRE_EQUAL(longest[longest.size() - 2], '=');
+    for (std::size_t length = 0; length <= longest.size(); ++length)
+    {
+      checkMatchesScalar(std::string_view(longest).substr(0, length), isa);
+    }
+  });
+}
+
+// Decoding stops at the first '=', also when text follows it
+BOOST_AUTO_TEST_CASE(PaddingMatchesScalar)
+{
+  forEachSupportedIsa([](const base64::Isa isa) {
+    for (const std::size_t length : {64U, 65U, 66U, 94U, 95U, 96U, 97U, 98U})
+    {
+      const std::string encoded = encode(randomBytes(length, static_cast<unsigned>(length)));
+      checkMatchesScalar(encoded + encode(randomBytes(48, 3U)), isa);
+      checkMatchesScalar(encoded + "\r\n" + encoded, isa);
+    }
+  });
+}
+
+// CR, LF, CRLF and space inserted at every offset of a 256-character text,
+// which covers both sides of each 16-, 32- and 64-character block boundary
+BOOST_AUTO_TEST_CASE(WhitespaceMatchesScalar)
+{
+  const std::vector<std::uint8_t> bytes = randomBytes(192, 11U);
+  const std::string encoded = encode(bytes);
+  forEachSupportedIsa([&](const base64::Isa isa) {
+    for (const std::string_view whitespace : {"\r", "\n", "\r\n", " "})
+    {
+      for (std::size_t offset = 0; offset <= encoded.size(); ++offset)
+      {
+        std::string text = encoded;
+        text.insert(offset, whitespace);
+        checkMatchesScalar(text, isa);
+
+        const DecodeResult actual = decode(text, isa);
+        BOOST_REQUIRE_MESSAGE(actual.bytes == bytes, "Whitespace at offset " << offset << " changed the decoded bytes");
+      }
+    }
+  });
+}
+
+BOOST_AUTO_TEST_CASE(InvalidCharacterThrows)
+{
+  const std::string encoded = encode(randomBytes(192, 13U));
+  forEachSupportedIsa([&](const base64::Isa isa) {
+    for (const char invalid : {'*', '-', '_', '\0', static_cast<char>(0x80), static_cast<char>(0xFF)})
+    {
+      for (std::size_t offset = 0; offset < encoded.size(); ++offset)
+      {
+        std::string text = encoded;
+        text[offset] = invalid;
+        BOOST_REQUIRE_THROW(static_cast<void>(decode(text, base64::Isa::Scalar)), Poco::DataFormatException);
+        BOOST_REQUIRE_THROW(static_cast<void>(decode(text, isa)), Poco::DataFormatException);
+      }
+    }
+  });
+}
+
+// Reads of every chunk size up to two AVX2 blocks stay within maxBytes + kOutputSlack
+BOOST_AUTO_TEST_CASE(ChunkedReadsStayInSlack)
+{
+  const std::vector<std::uint8_t> bytes = randomBytes(k_MaxDecodedLength, 17U);
+  std::string wrapped = encode(bytes);
+  for (std::size_t offset = 76; offset < wrapped.size(); offset += 78)
+  {
+    wrapped.insert(offset, "\r\n");
+  }
+
+  forEachSupportedIsa([&](const base64::Isa isa) {
+    for (const std::string& encoded : {encode(bytes), wrapped})
+    {
+      for (std::size_t chunkSize = 3; chunkSize <= 48; ++chunkSize)
+      {
+        const DecodeResult expected = decodeChunked(encoded, base64::Isa::Scalar, chunkSize);
+        const DecodeResult actual = decodeChunked(encoded, isa, chunkSize);
+        BOOST_REQUIRE_MESSAGE(expected.guardIntact && actual.guardIntact,
+          "Write past maxBytes + kOutputSlack with chunks of " << chunkSize << " bytes");
+        BOOST_REQUIRE_EQUAL(actual.size, expected.size);
+        BOOST_REQUIRE(actual.bytes == expected.bytes);
+        BOOST_REQUIRE(actual.bytes == bytes);
+      }
+    }
+  });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
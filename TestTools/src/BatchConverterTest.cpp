@@ -0,0 +1,70 @@
+// CLI batch conversion: output file naming.
+// AssignOutputPaths is checked for:
+//   - the same file name in two sub-directories (later one gets _1)
+//   - names differing only by case, which collide on case-insensitive file systems
+//   - an input already named like a suffixed output (a_1.dcm after a -> a_1)
+//   - binary formats writing their text format's extension (plyb -> .ply, stlb -> .stl)
+
+#define BOOST_TEST_MODULE BatchConverterTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "BatchConverter.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static void checkOutputs(const std::vector<fs::path>& inputs,
+                         const std::string& format,
+                         const std::vector<std::string>& expectedFilenames)
+{
+  const fs::path outputDir = fs::path("out") / "2026-01-01-00-00-00";
+  const auto outputs = internal::AssignOutputPaths(inputs, outputDir, format);
+  BOOST_REQUIRE_EQUAL(outputs.size(), expectedFilenames.size());
+  for (std::size_t i = 0; i < outputs.size(); ++i)
+  {
+    BOOST_CHECK_EQUAL(outputs[i].parent_path().generic_string(), outputDir.generic_string());
+    BOOST_CHECK_EQUAL(outputs[i].filename().string(), expectedFilenames[i]);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE(OutputNaming)
+
+BOOST_AUTO_TEST_CASE(SameStemInTwoDirectories)
+{
+  checkOutputs({fs::path("upper") / "scan.dcm", fs::path("lower") / "scan.dcm", fs::path("lower") / "bite.dcm"},
+               "stl", {"scan.stl", "scan_1.stl", "bite.stl"});
+  checkOutputs({fs::path("a") / "scan.dcm", fs::path("b") / "scan.dcm", fs::path("c") / "scan.dcm"},
+               "obj", {"scan.obj", "scan_1.obj", "scan_2.obj"});
+}
+
+BOOST_AUTO_TEST_CASE(CollisionDifferingOnlyByCase)
+{
+  checkOutputs({fs::path("x") / "A.dcm", fs::path("y") / "a.dcm"}, "ply", {"A.ply", "a_1.ply"});
+  checkOutputs({fs::path("x") / "Scan.dcm", fs::path("y") / "SCAN.DCM", fs::path("z") / "scan.dcm"},
+               "glb", {"Scan.glb", "SCAN_1.glb", "scan_2.glb"});
+}
+
+BOOST_AUTO_TEST_CASE(InputNamedLikeSuffixedOutput)
+{
+  checkOutputs({fs::path("x") / "a.dcm", fs::path("y") / "a.dcm", fs::path("y") / "a_1.dcm"},
+               "stl", {"a.stl", "a_1.stl", "a_1_1.stl"});
+  // An input claiming a_1 first pushes the later duplicate of a on to a_2
+  checkOutputs({fs::path("y") / "a_1.dcm", fs::path("x") / "a.dcm", fs::path("y") / "a.dcm"},
+               "stl", {"a_1.stl", "a.stl", "a_2.stl"});
+}
+
+BOOST_AUTO_TEST_CASE(BinaryFormatsKeepExtension)
+{
+  BOOST_CHECK_EQUAL(internal::OutputExtension("plyb"), "ply");
+  BOOST_CHECK_EQUAL(internal::OutputExtension("stlb"), "stl");
+  BOOST_CHECK_EQUAL(internal::OutputExtension("ply"), "ply");
+  BOOST_CHECK_EQUAL(internal::OutputExtension("glb"), "glb");
+
+  checkOutputs({fs::path("x") / "scan.dcm", fs::path("y") / "scan.dcm"}, "plyb", {"scan.ply", "scan_1.ply"});
+  checkOutputs({fs::path("x") / "scan.dcm", fs::path("y") / "scan.dcm"}, "stlb", {"scan.stl", "scan_1.stl"});
+}
+
+BOOST_AUTO_TEST_SUITE_END()
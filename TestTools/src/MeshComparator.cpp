@@ -7,6 +7,10 @@
 #include <set>
 #include <array>
 #include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
 #include <vector>
 #include <map>
 
@@ -249,5 +253,110 @@ namespace Open3SDCM::Test
         fmt::print("Overall: {}\n\n", result.isSuccess() ? "✓ TEST PASSED" : "✗ TEST FAILED");
     }
 
+    BinaryStl MeshComparator::loadBinaryStl(const std::filesystem::path& filePath)
+    {
+        constexpr size_t headerSize = 80;
+        constexpr size_t facetSize = 50;
+
+        std::ifstream input(filePath, std::ios::binary);
+        const std::vector<char> bytes((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+        if (!input.good() && !input.eof())
+        {
+            throw std::runtime_error(fmt::format("Failed to read STL from: {}", filePath.string()));
+        }
+        if (bytes.size() < headerSize + 4)
+        {
+            throw std::runtime_error(fmt::format("Truncated STL header in: {}", filePath.string()));
+        }
+
+        BinaryStl stl;
+        stl.header.assign(bytes.data(), headerSize);
+        std::memcpy(&stl.faceCount, bytes.data() + headerSize, sizeof(stl.faceCount));
+        stl.fileSize = bytes.size();
+
+        // Only the facets actually present; a short file fails the size check
+        const size_t available = (bytes.size() - headerSize - 4) / facetSize;
+        stl.facets.resize(std::min<size_t>(stl.faceCount, available));
+        for (size_t i = 0; i < stl.facets.size(); ++i)
+        {
+            float values[12];
+            std::memcpy(values, bytes.data() + headerSize + 4 + i * facetSize, sizeof(values));
+            stl.facets[i].normal = {values[0], values[1], values[2]};
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                stl.facets[i].corners[corner] = {values[3 + corner * 3], values[4 + corner * 3], values[5 + corner * 3]};
+            }
+        }
+        return stl;
+    }
+
+    // Rotates the corners so that the smallest comes first, keeping the winding
+    static std::array<Vertex, 3> canonicalCorners(const StlFacet& facet)
+    {
+        const auto& c = facet.corners;
+        if (!(c[1] < c[0]) && !(c[2] < c[0])) {
+            return {c[0], c[1], c[2]};
+        } else if (!(c[2] < c[1])) {
+            return {c[1], c[2], c[0]};
+        } else {
+            return {c[2], c[0], c[1]};
+        }
+    }
+
+    static std::vector<StlFacet> sortedFacets(const BinaryStl& stl)
+    {
+        std::vector<StlFacet> facets = stl.facets;
+        for (auto& facet : facets) {
+            facet.corners = canonicalCorners(facet);
+        }
+        std::sort(facets.begin(), facets.end(), [](const StlFacet& a, const StlFacet& b) {
+            return std::lexicographical_compare(a.corners.begin(), a.corners.end(), b.corners.begin(), b.corners.end());
+        });
+        return facets;
+    }
+
+    MeshComparator::StlComparisonResult MeshComparator::compareBinaryStl(
+        const BinaryStl& reference,
+        const BinaryStl& test,
+        float epsilon,
+        float normalEpsilon)
+    {
+        StlComparisonResult result;
+        result.headerValid = test.header.rfind("solid", 0) != 0;
+        result.sizeValid = test.fileSize == 84 + 50 * static_cast<std::uintmax_t>(test.faceCount);
+        result.expectedFaceCount = reference.faceCount;
+        result.actualFaceCount = test.faceCount;
+
+        const auto referenceFacets = sortedFacets(reference);
+        const auto testFacets = sortedFacets(test);
+        const size_t compared = std::min(referenceFacets.size(), testFacets.size());
+        for (size_t i = 0; i < compared; ++i)
+        {
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                if (!referenceFacets[i].corners[corner].isClose(testFacets[i].corners[corner], epsilon))
+                {
+                    ++result.mismatchedVertices;
+                }
+            }
+            if (!referenceFacets[i].normal.isClose(testFacets[i].normal, normalEpsilon))
+            {
+                ++result.mismatchedNormals;
+            }
+        }
+        return result;
+    }
+
+    void MeshComparator::printResult(const StlComparisonResult& result)
+    {
+        fmt::print("\n=== Binary STL Comparison Results ===\n\n");
+        fmt::print("Header:     {}\n", result.headerValid ? "✓ PASS" : "✗ FAIL (starts with \"solid\")");
+        fmt::print("File size:  {}\n", result.sizeValid ? "✓ PASS" : "✗ FAIL (not 84 + 50 x faces)");
+        fmt::print("Faces:      expected {}, actual {}\n", result.expectedFaceCount, result.actualFaceCount);
+        fmt::print("Vertices:   {} mismatched\n", result.mismatchedVertices);
+        fmt::print("Normals:    {} mismatched\n\n", result.mismatchedNormals);
+        fmt::print("Overall: {}\n\n", result.isSuccess() ? "✓ TEST PASSED" : "✗ TEST FAILED");
+    }
+
 } // namespace Open3SDCM::Test
 
@@ -3,6 +3,7 @@
 #include <filesystem>
 #include <vector>
 #include <array>
+#include <cstdint>
 #include <string>
 #include <set>
 #include <cmath>
@@ -33,6 +34,21 @@ namespace Open3SDCM::Test
         std::vector<Face> faces;
     };
 
+    struct StlFacet
+    {
+        Vertex normal;
+        std::array<Vertex, 3> corners;
+    };
+
+    // A binary STL file as written, facet by facet
+    struct BinaryStl
+    {
+        std::string header; // the 80 header bytes
+        std::uint32_t faceCount = 0;
+        std::uintmax_t fileSize = 0;
+        std::vector<StlFacet> facets;
+    };
+
     class MeshComparator
     {
     public:
@@ -60,6 +76,32 @@ namespace Open3SDCM::Test
 
         // Print comparison result
         static void printResult(const ComparisonResult& result);
+
+        struct StlComparisonResult
+        {
+            bool headerValid = false;   // the test header does not start with "solid"
+            bool sizeValid = false;     // the test file is 84 + 50 * faces bytes
+            size_t expectedFaceCount = 0;
+            size_t actualFaceCount = 0;
+            size_t mismatchedVertices = 0;
+            size_t mismatchedNormals = 0;
+
+            bool isSuccess() const
+            {
+                return headerValid && sizeValid && expectedFaceCount == actualFaceCount &&
+                       mismatchedVertices == 0 && mismatchedNormals == 0;
+            }
+        };
+
+        // Reads a binary STL without Assimp, keeping the header and the facet normals
+        static BinaryStl loadBinaryStl(const std::filesystem::path& filePath);
+
+        // Pairs the facets of both files by their corners (the facet order does not
+        // matter) and compares corners and normals with separate tolerances
+        static StlComparisonResult compareBinaryStl(const BinaryStl& reference, const BinaryStl& test,
+                                                    float epsilon = 1e-5f, float normalEpsilon = 1e-3f);
+
+        static void printResult(const StlComparisonResult& result);
     };
 
 } // namespace Open3SDCM::Test
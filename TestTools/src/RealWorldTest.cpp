@@ -3,27 +3,48 @@
 //   - exact vertex/face counts (regression guard for decryption + facet decoding)
 //   - geometry integrity (all vertex floats finite, all indices in range)
 //   - surface metadata + decoded UVs for textured CE samples
+//   - vertices, triangles and UVs identical to the former Poco DOM parser's output
 //   - successful PLY/OBJ export with preserved color/texture artifacts where supported
+//   - binary PLY records read back equal to the parse result
 
 #define BOOST_TEST_MODULE RealWorldConversionTest
 #include <boost/test/included/unit_test.hpp>
 
+#include "Log.h"
 #include "ParseDcm.h"
 
+#include <algorithm>
+#include <bit>
 #include <cmath>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <memory_resource>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <string_view>
 
+#include <spdlog/sinks/ostream_sink.h>
+
 namespace fs = std::filesystem;
 
 #ifndef TEST_DATA_DIR
 #define TEST_DATA_DIR "."
 #endif
 
+// FNV-1a digests of the parse result: vertex floats and UVs by bit pattern,
+// triangle corners as 32-bit indices, each UV corner prefixed by a presence
+// byte, all little-endian. Recorded from the Poco DOM parser the pull parser
+// replaced (baseline tree); all zero for scans that were not available then,
+// which skips only the parity check.
+struct ReferenceDigests
+{
+  std::uint64_t vertices;
+  std::uint64_t triangles;
+  std::uint64_t textureCoordinates;
+};
+
 struct ScanSpec
 {
   const char* filename;
@@ -33,14 +54,18 @@ struct ScanSpec
   bool hasTextureData;
   bool verifyObjExport;
   bool expectUvSeams;
+  ReferenceDigests domReference;
 };
 
 static constexpr ScanSpec k_Scans[] = {
-  {"scan_040.dcm",  50648, 101292, 8421504U, false, false, false},
-  {"scan_039.dcm",  68698, 136995, 8421504U, false, false, false},
-  {"scan_012.dcm",  60117, 120230, 8421504U, true,  true,  true },
-  {"scan_019.dcm",  95497, 190206, 8421504U, true,  false, true },
-  {"scan_045.dcm",  99619, 198513, 8421504U, true,  false, true },
+  {"scan_040.dcm",  50648, 101292, 8421504U, false, false, false,
+   {0x3376094529CFFF1BULL, 0xA66A31F496E4F7C4ULL, 0xCBF29CE484222325ULL}},
+  {"scan_039.dcm",  68698, 136995, 8421504U, false, false, false,
+   {0x2B9533528B50F66CULL, 0xD3135B1AA81DA873ULL, 0xCBF29CE484222325ULL}},
+  {"scan_012.dcm",  60117, 120230, 8421504U, true,  true,  true,
+   {0x0F170286DECCC2A3ULL, 0x881C679F57062DE4ULL, 0xC51F9C4CEF43E43AULL}},
+  {"scan_019.dcm",  95497, 190206, 8421504U, true,  false, true,  {}},
+  {"scan_045.dcm",  99619, 198513, 8421504U, true,  false, true,  {}},
 };
 
 struct TempOutputDir
@@ -82,6 +107,69 @@ static bool allIndicesInRange(const std::vector<Open3SDCM::Triangle>& triangles,
   return true;
 }
 
+class Fnv1a
+{
+public:
+  void Add(const std::uint8_t byte)
+  {
+    m_Hash = (m_Hash ^ byte) * 1099511628211ULL;
+  }
+
+  void Add(const std::uint32_t value)
+  {
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+      Add(static_cast<std::uint8_t>(value >> shift));
+    }
+  }
+
+  void Add(const float value)
+  {
+    Add(std::bit_cast<std::uint32_t>(value));
+  }
+
+  [[nodiscard]] std::uint64_t Hash() const
+  {
+    return m_Hash;
+  }
+
+private:
+  std::uint64_t m_Hash{14695981039346656037ULL};
+};
+
+static ReferenceDigests digestParseResult(const Open3SDCM::DCMParser& parser)
+{
+  Fnv1a vertices;
+  for (const float coordinate : parser.m_Vertices)
+  {
+    vertices.Add(coordinate);
+  }
+
+  Fnv1a triangles;
+  for (const auto& triangle : parser.m_Triangles)
+  {
+    triangles.Add(std::uint32_t{triangle.v1});
+    triangles.Add(std::uint32_t{triangle.v2});
+    triangles.Add(std::uint32_t{triangle.v3});
+  }
+
+  Fnv1a textureCoordinates;
+  for (const auto& textureCoordinateData : parser.m_SurfaceData.textureCoordinates)
+  {
+    for (const auto& coordinate : textureCoordinateData.cornerCoordinates)
+    {
+      textureCoordinates.Add(static_cast<std::uint8_t>(coordinate.has_value()));
+      if (coordinate.has_value())
+      {
+        textureCoordinates.Add(coordinate->u);
+        textureCoordinates.Add(coordinate->v);
+      }
+    }
+  }
+
+  return {vertices.Hash(), triangles.Hash(), textureCoordinates.Hash()};
+}
+
 static std::string readTextFile(const fs::path& path)
 {
   std::ifstream input(path, std::ios::binary);
@@ -262,6 +350,20 @@ static void runConversionTest(const ScanSpec& spec)
     BOOST_CHECK(parser.m_SurfaceData.textureImages.empty());
   }
 
+  // Parity with the Poco DOM parser, bit for bit
+  const ReferenceDigests& reference = spec.domReference;
+  if (reference.vertices == 0 && reference.triangles == 0 && reference.textureCoordinates == 0)
+  {
+    BOOST_TEST_MESSAGE("No DOM reference digests recorded for " << spec.filename << ", parity not checked");
+  }
+  else
+  {
+    const ReferenceDigests digests = digestParseResult(parser);
+    BOOST_CHECK_EQUAL(digests.vertices, reference.vertices);
+    BOOST_CHECK_EQUAL(digests.triangles, reference.triangles);
+    BOOST_CHECK_EQUAL(digests.textureCoordinates, reference.textureCoordinates);
+  }
+
   TempOutputDir tmp(spec.filename);
   const fs::path stem = fs::path(spec.filename).stem();
   const fs::path ply = tmp.path / (stem.string() + ".ply");
@@ -323,6 +425,583 @@ static void runConversionTest(const ScanSpec& spec)
   }
 }
 
+// ParseOptions::concurrentDecode must decode exactly what the sequential path decodes
+static void runConcurrentDecodeTest(const ScanSpec& spec)
+{
+  const fs::path dcm = fs::path(TEST_DATA_DIR) / "real-world" / spec.filename;
+  BOOST_REQUIRE_MESSAGE(fs::exists(dcm), "DCM file not found: " << dcm.string());
+
+  Open3SDCM::DCMParser sequential;
+  sequential.ParseDCM(dcm);
+
+  Open3SDCM::ParseOptions options;
+  options.concurrentDecode = true;
+  Open3SDCM::DCMParser concurrent;
+  concurrent.ParseDCM(dcm, options);
+
+  BOOST_CHECK(concurrent.m_Vertices == sequential.m_Vertices);
+  BOOST_REQUIRE_EQUAL(concurrent.m_Triangles.size(), sequential.m_Triangles.size());
+  for (std::size_t i = 0; i < sequential.m_Triangles.size(); ++i)
+  {
+    const auto& lhs = concurrent.m_Triangles[i];
+    const auto& rhs = sequential.m_Triangles[i];
+    BOOST_REQUIRE_MESSAGE(lhs.v1 == rhs.v1 && lhs.v2 == rhs.v2 && lhs.v3 == rhs.v3,
+      "Triangle " << i << " differs in " << spec.filename);
+  }
+  BOOST_CHECK(concurrent.m_FacetDecodeInfo.width == sequential.m_FacetDecodeInfo.width);
+
+  BOOST_REQUIRE(concurrent.m_SurfaceData.baseColor.has_value());
+  BOOST_CHECK_EQUAL(concurrent.m_SurfaceData.baseColor->PackedRGB(), sequential.m_SurfaceData.baseColor->PackedRGB());
+
+  BOOST_REQUIRE_EQUAL(concurrent.m_SurfaceData.textureImages.size(), sequential.m_SurfaceData.textureImages.size());
+  for (std::size_t i = 0; i < sequential.m_SurfaceData.textureImages.size(); ++i)
+  {
+    BOOST_CHECK(concurrent.m_SurfaceData.textureImages[i].imageBytes == sequential.m_SurfaceData.textureImages[i].imageBytes);
+  }
+
+  BOOST_REQUIRE_EQUAL(concurrent.m_SurfaceData.textureCoordinates.size(), sequential.m_SurfaceData.textureCoordinates.size());
+  for (std::size_t i = 0; i < sequential.m_SurfaceData.textureCoordinates.size(); ++i)
+  {
+    const auto& lhs = concurrent.m_SurfaceData.textureCoordinates[i].cornerCoordinates;
+    const auto& rhs = sequential.m_SurfaceData.textureCoordinates[i].cornerCoordinates;
+    BOOST_REQUIRE_EQUAL(lhs.size(), rhs.size());
+    for (std::size_t corner = 0; corner < rhs.size(); ++corner)
+    {
+      BOOST_REQUIRE_EQUAL(lhs[corner].has_value(), rhs[corner].has_value());
+      if (rhs[corner])
+      {
+        BOOST_REQUIRE(lhs[corner]->u == rhs[corner]->u && lhs[corner]->v == rhs[corner]->v);
+      }
+    }
+  }
+}
+
+// ExportOptions::deduplicateTextureCoordinates: fewer "vt" lines, same UV on every corner
+static void runIndexedUvExportTest(const ScanSpec& spec)
+{
+  const fs::path dcm = fs::path(TEST_DATA_DIR) / "real-world" / spec.filename;
+  BOOST_REQUIRE_MESSAGE(fs::exists(dcm), "DCM file not found: " << dcm.string());
+
+  Open3SDCM::DCMParser parser;
+  parser.ParseDCM(dcm);
+  BOOST_REQUIRE_EQUAL(parser.m_SurfaceData.textureCoordinates.size(), 1u);
+  const auto& decodedCoordinates = parser.m_SurfaceData.textureCoordinates.front().cornerCoordinates;
+  BOOST_REQUIRE_EQUAL(decodedCoordinates.size(), parser.m_Triangles.size() * 3u);
+
+  TempOutputDir tmp("indexed_uvs");
+  const fs::path obj = tmp.path / (fs::path(spec.filename).stem().string() + ".obj");
+  Open3SDCM::ExportOptions options;
+  options.deduplicateTextureCoordinates = true;
+  BOOST_REQUIRE(parser.ExportMesh(obj, "obj", options));
+
+  const std::string objText = readTextFile(obj);
+  const auto exportedCoordinates = parseObjTextureCoordinates(objText);
+  BOOST_CHECK_GT(exportedCoordinates.size(), 0u);
+  BOOST_CHECK_LT(exportedCoordinates.size(), decodedCoordinates.size());
+  BOOST_TEST_MESSAGE("vt lines: " << exportedCoordinates.size() << " for " << decodedCoordinates.size() << " corners");
+
+  std::istringstream input(objText);
+  std::string line;
+  std::size_t cornerIndex = 0;
+  while (std::getline(input, line))
+  {
+    if (!line.starts_with("f "))
+    {
+      continue;
+    }
+
+    std::istringstream lineInput(line.substr(2));
+    std::string corner;
+    while (lineInput >> corner)
+    {
+      const std::size_t slash = corner.find('/');
+      BOOST_REQUIRE(slash != std::string::npos);
+      const std::size_t textureIndex = std::stoul(corner.substr(slash + 1));
+      BOOST_REQUIRE_GE(textureIndex, 1u);
+      BOOST_REQUIRE_LE(textureIndex, exportedCoordinates.size());
+      BOOST_REQUIRE_LT(cornerIndex, decodedCoordinates.size());
+
+      const auto& decodedCoordinate = decodedCoordinates[cornerIndex];
+      const Open3SDCM::TextureCoordinate expectedCoordinate = decodedCoordinate.has_value()
+        ? Open3SDCM::TextureCoordinate{decodedCoordinate->u, 1.0F - decodedCoordinate->v}
+        : Open3SDCM::TextureCoordinate{};
+      BOOST_REQUIRE_MESSAGE(textureCoordinatesNearlyEqual(exportedCoordinates[textureIndex - 1], expectedCoordinate),
+        "Unexpected indexed OBJ UV at corner " << cornerIndex << " in " << spec.filename);
+      ++cornerIndex;
+    }
+  }
+  BOOST_CHECK_EQUAL(cornerIndex, decodedCoordinates.size());
+}
+
+static std::uint32_t readLittleEndian32(const std::string& bytes, const std::size_t offset)
+{
+  std::uint32_t value = 0;
+  for (std::size_t byteIndex = 0; byteIndex < 4; ++byteIndex)
+  {
+    value |= static_cast<std::uint32_t>(static_cast<unsigned char>(bytes[offset + byteIndex])) << (8 * byteIndex);
+  }
+  return value;
+}
+
+// GLB export: valid container, one vertex per (vertex, UV) pair, indices in range,
+// and the embedded JPEG copied byte for byte into the binary chunk
+static void runGlbExportTest(const ScanSpec& spec)
+{
+  const fs::path dcm = fs::path(TEST_DATA_DIR) / "real-world" / spec.filename;
+  BOOST_REQUIRE_MESSAGE(fs::exists(dcm), "DCM file not found: " << dcm.string());
+
+  Open3SDCM::DCMParser parser;
+  parser.ParseDCM(dcm);
+  BOOST_REQUIRE_EQUAL(parser.m_SurfaceData.textureImages.size(), 1u);
+  const auto& imageBytes = parser.m_SurfaceData.textureImages.front().imageBytes;
+  BOOST_REQUIRE(!imageBytes.empty());
+
+  TempOutputDir tmp("glb_export");
+  const fs::path glb = tmp.path / (fs::path(spec.filename).stem().string() + ".glb");
+  BOOST_REQUIRE(parser.ExportMesh(glb, "glb"));
+
+  const std::string bytes = readTextFile(glb);
+  BOOST_REQUIRE_GE(bytes.size(), 28u);
+  BOOST_CHECK_EQUAL(readLittleEndian32(bytes, 0), 0x46546C67U);
+  BOOST_CHECK_EQUAL(readLittleEndian32(bytes, 4), 2u);
+  BOOST_REQUIRE_EQUAL(readLittleEndian32(bytes, 8), bytes.size());
+
+  const std::size_t jsonSize = readLittleEndian32(bytes, 12);
+  BOOST_CHECK_EQUAL(readLittleEndian32(bytes, 16), 0x4E4F534AU);
+  BOOST_REQUIRE_EQUAL(jsonSize % 4, 0u);
+  const std::string json = bytes.substr(20, jsonSize);
+  BOOST_CHECK_NE(json.find("\"TEXCOORD_0\":1"), std::string::npos);
+  BOOST_CHECK_NE(json.find("\"mimeType\":\"image/jpeg\""), std::string::npos);
+
+  const std::size_t binaryOffset = 20 + jsonSize + 8;
+  const std::size_t binarySize = readLittleEndian32(bytes, 20 + jsonSize);
+  BOOST_CHECK_EQUAL(readLittleEndian32(bytes, 24 + jsonSize), 0x004E4942U);
+  BOOST_REQUIRE_EQUAL(binaryOffset + binarySize, bytes.size());
+
+  // The POSITION accessor comes first; its vertex count bounds every index
+  const std::string countKey = "\"count\":";
+  const std::size_t countPosition = json.find(countKey);
+  BOOST_REQUIRE_NE(countPosition, std::string::npos);
+  const std::size_t vertexCount = std::stoul(json.substr(countPosition + countKey.size()));
+  BOOST_CHECK_GE(vertexCount, parser.m_Vertices.size() / 3);
+  BOOST_CHECK_LE(vertexCount, parser.m_Triangles.size() * 3);
+  BOOST_TEST_MESSAGE("GLB vertices: " << vertexCount << " for " << parser.m_Vertices.size() / 3 << " DCM vertices");
+
+  // Positions (VEC3), then UVs (VEC2), then the uint32 indices
+  const std::size_t indicesOffset = binaryOffset + vertexCount * 5 * sizeof(float);
+  const std::size_t indexCount = parser.m_Triangles.size() * 3;
+  BOOST_REQUIRE_LE(indicesOffset + indexCount * 4, bytes.size());
+  for (std::size_t index = 0; index < indexCount; ++index)
+  {
+    BOOST_REQUIRE_LT(readLittleEndian32(bytes, indicesOffset + index * 4), vertexCount);
+  }
+
+  const std::string_view image(reinterpret_cast<const char*>(imageBytes.data()), imageBytes.size());
+  BOOST_CHECK_EQUAL(std::string_view(bytes).substr(indicesOffset + indexCount * 4, image.size()), image);
+}
+
+static float readLittleEndianFloat(const std::string& bytes, const std::size_t offset)
+{
+  return std::bit_cast<float>(readLittleEndian32(bytes, offset));
+}
+
+// Binary PLY export: header elements and properties, then every vertex float and
+// color, every face index and, with full UV data, the per-face texcoord lists
+// (decoded corner UVs with V flipped), read back from the little-endian blocks
+static void runPlybExportTest(const ScanSpec& spec)
+{
+  const fs::path dcm = fs::path(TEST_DATA_DIR) / "real-world" / spec.filename;
+  BOOST_REQUIRE_MESSAGE(fs::exists(dcm), "DCM file not found: " << dcm.string());
+
+  Open3SDCM::DCMParser parser;
+  parser.ParseDCM(dcm);
+  BOOST_REQUIRE(parser.m_SurfaceData.baseColor.has_value());
+  const std::size_t vertexCount = parser.m_Vertices.size() / 3;
+  const std::size_t faceCount = parser.m_Triangles.size();
+
+  const std::vector<std::optional<Open3SDCM::TextureCoordinate>>* cornerCoordinates = nullptr;
+  if (spec.hasTextureData)
+  {
+    BOOST_REQUIRE_EQUAL(parser.m_SurfaceData.textureCoordinates.size(), 1u);
+    cornerCoordinates = &parser.m_SurfaceData.textureCoordinates.front().cornerCoordinates;
+    BOOST_REQUIRE_EQUAL(cornerCoordinates->size(), faceCount * 3);
+  }
+
+  TempOutputDir tmp("plyb_export");
+  const fs::path ply = tmp.path / (fs::path(spec.filename).stem().string() + ".ply");
+  BOOST_REQUIRE(parser.ExportMesh(ply, "plyb"));
+
+  const std::string bytes = readTextFile(ply);
+  const std::string endHeader = "end_header\n";
+  const std::size_t headerEnd = bytes.find(endHeader);
+  BOOST_REQUIRE_NE(headerEnd, std::string::npos);
+
+  std::string expectedHeader = "ply\nformat binary_little_endian 1.0\n";
+  expectedHeader += "element vertex " + std::to_string(vertexCount) + "\n";
+  expectedHeader += "property float x\nproperty float y\nproperty float z\n";
+  expectedHeader += "property uchar red\nproperty uchar green\nproperty uchar blue\n";
+  expectedHeader += "element face " + std::to_string(faceCount) + "\n";
+  expectedHeader += "property list uchar int vertex_indices\n";
+  if (cornerCoordinates != nullptr)
+  {
+    expectedHeader += "property list uchar float texcoord\n";
+  }
+  BOOST_REQUIRE_EQUAL(bytes.substr(0, headerEnd), expectedHeader);
+
+  const std::size_t vertexOffset = headerEnd + endHeader.size();
+  const std::size_t vertexRecordSize = 3 * sizeof(float) + 3;
+  const std::size_t faceOffset = vertexOffset + vertexCount * vertexRecordSize;
+  const std::size_t faceRecordSize = 1 + 3 * sizeof(std::uint32_t) + (cornerCoordinates != nullptr ? 1 + 6 * sizeof(float) : 0);
+  BOOST_REQUIRE_EQUAL(bytes.size(), faceOffset + faceCount * faceRecordSize);
+
+  const auto& color = *parser.m_SurfaceData.baseColor;
+  for (std::size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+  {
+    const std::size_t record = vertexOffset + vertexIndex * vertexRecordSize;
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+      BOOST_REQUIRE_MESSAGE(std::bit_cast<std::uint32_t>(parser.m_Vertices[vertexIndex * 3 + axis]) ==
+                              readLittleEndian32(bytes, record + axis * 4),
+        "Unexpected PLY coordinate at vertex " << vertexIndex << " in " << spec.filename);
+    }
+    BOOST_REQUIRE_EQUAL(static_cast<unsigned char>(bytes[record + 12]), color.r);
+    BOOST_REQUIRE_EQUAL(static_cast<unsigned char>(bytes[record + 13]), color.g);
+    BOOST_REQUIRE_EQUAL(static_cast<unsigned char>(bytes[record + 14]), color.b);
+  }
+
+  for (std::size_t faceIndex = 0; faceIndex < faceCount; ++faceIndex)
+  {
+    const std::size_t record = faceOffset + faceIndex * faceRecordSize;
+    const auto& triangle = parser.m_Triangles[faceIndex];
+    BOOST_REQUIRE_EQUAL(static_cast<unsigned char>(bytes[record]), 3u);
+    BOOST_REQUIRE_MESSAGE(readLittleEndian32(bytes, record + 1) == triangle.v1 &&
+                            readLittleEndian32(bytes, record + 5) == triangle.v2 &&
+                            readLittleEndian32(bytes, record + 9) == triangle.v3,
+      "Unexpected PLY indices at face " << faceIndex << " in " << spec.filename);
+    if (cornerCoordinates == nullptr)
+    {
+      continue;
+    }
+
+    BOOST_REQUIRE_EQUAL(static_cast<unsigned char>(bytes[record + 13]), 6u);
+    for (std::size_t corner = 0; corner < 3; ++corner)
+    {
+      const auto& decodedCoordinate = (*cornerCoordinates)[faceIndex * 3 + corner];
+      const Open3SDCM::TextureCoordinate expectedCoordinate = decodedCoordinate.has_value()
+        ? Open3SDCM::TextureCoordinate{decodedCoordinate->u, 1.0F - decodedCoordinate->v}
+        : Open3SDCM::TextureCoordinate{};
+      const Open3SDCM::TextureCoordinate exportedCoordinate{readLittleEndianFloat(bytes, record + 14 + corner * 8),
+                                                             readLittleEndianFloat(bytes, record + 18 + corner * 8)};
+      BOOST_REQUIRE_MESSAGE(textureCoordinatesNearlyEqual(exportedCoordinate, expectedCoordinate),
+        "Unexpected PLY texcoord at face " << faceIndex << " corner " << corner << " in " << spec.filename);
+    }
+  }
+}
+
+// Decoded-mesh cache: a loaded entry equals the parse it was written from, and is
+// refused for any other source content
+static void runMeshCacheTest(const ScanSpec& spec, const ScanSpec& otherSpec)
+{
+  const fs::path dcm = fs::path(TEST_DATA_DIR) / "real-world" / spec.filename;
+  const fs::path otherDcm = fs::path(TEST_DATA_DIR) / "real-world" / otherSpec.filename;
+  BOOST_REQUIRE_MESSAGE(fs::exists(dcm), "DCM file not found: " << dcm.string());
+  BOOST_REQUIRE_MESSAGE(fs::exists(otherDcm), "DCM file not found: " << otherDcm.string());
+
+  Open3SDCM::DCMParser parser;
+  parser.ParseDCM(dcm);
+  BOOST_REQUIRE_EQUAL(parser.m_Vertices.size(), spec.expectedVertices * 3);
+
+  TempOutputDir tmp("mesh_cache");
+  const fs::path cache = tmp.path / (fs::path(spec.filename).stem().string() + ".o3mc");
+  BOOST_REQUIRE(parser.WriteCache(cache, dcm));
+
+  Open3SDCM::DCMParser stale;
+  BOOST_CHECK(!stale.LoadCache(cache, otherDcm));
+  BOOST_CHECK(stale.m_Vertices.empty());
+
+  // An entry of another decoder revision is a miss, like one of other content
+  const fs::path otherRevision = tmp.path / "other_revision.o3mc";
+  {
+    std::string entry = readTextFile(cache);
+    BOOST_REQUIRE_GT(entry.size(), 64U);
+    entry[56] = static_cast<char>(entry[56] + 1);// u32 decoder revision
+    std::ofstream(otherRevision, std::ios::binary) << entry;
+  }
+  BOOST_CHECK(!stale.LoadCache(otherRevision, dcm));
+  BOOST_CHECK(stale.m_Vertices.empty());
+
+  Open3SDCM::DCMParser cached;
+  BOOST_REQUIRE(cached.LoadCache(cache, dcm));
+  BOOST_CHECK(cached.m_Vertices == parser.m_Vertices);
+  BOOST_REQUIRE_EQUAL(cached.m_Triangles.size(), parser.m_Triangles.size());
+  const auto cachedIndices = Open3SDCM::AsIndexBuffer(cached.m_Triangles);
+  const auto parsedIndices = Open3SDCM::AsIndexBuffer(parser.m_Triangles);
+  BOOST_CHECK(std::equal(cachedIndices.begin(), cachedIndices.end(), parsedIndices.begin()));
+  BOOST_CHECK_EQUAL(cached.m_FacetDecodeInfo.decodedFaceCount, parser.m_FacetDecodeInfo.decodedFaceCount);
+
+  const auto& surface = cached.m_SurfaceData;
+  BOOST_REQUIRE(surface.baseColor.has_value() == parser.m_SurfaceData.baseColor.has_value());
+  BOOST_REQUIRE_EQUAL(surface.textureCoordinates.size(), parser.m_SurfaceData.textureCoordinates.size());
+  for (std::size_t setIndex = 0; setIndex < surface.textureCoordinates.size(); ++setIndex)
+  {
+    const auto& cachedCorners = surface.textureCoordinates[setIndex].cornerCoordinates;
+    const auto& parsedCorners = parser.m_SurfaceData.textureCoordinates[setIndex].cornerCoordinates;
+    BOOST_CHECK(surface.textureCoordinates[setIndex].textureCoordId == parser.m_SurfaceData.textureCoordinates[setIndex].textureCoordId);
+    BOOST_REQUIRE_EQUAL(cachedCorners.size(), parsedCorners.size());
+    for (std::size_t cornerIndex = 0; cornerIndex < cachedCorners.size(); ++cornerIndex)
+    {
+      BOOST_REQUIRE(cachedCorners[cornerIndex].has_value() == parsedCorners[cornerIndex].has_value());
+      if (cachedCorners[cornerIndex].has_value())
+      {
+        BOOST_REQUIRE(cachedCorners[cornerIndex]->u == parsedCorners[cornerIndex]->u);
+        BOOST_REQUIRE(cachedCorners[cornerIndex]->v == parsedCorners[cornerIndex]->v);
+      }
+    }
+  }
+  BOOST_REQUIRE_EQUAL(surface.textureImages.size(), parser.m_SurfaceData.textureImages.size());
+  for (std::size_t imageIndex = 0; imageIndex < surface.textureImages.size(); ++imageIndex)
+  {
+    BOOST_CHECK(surface.textureImages[imageIndex].imageBytes == parser.m_SurfaceData.textureImages[imageIndex].imageBytes);
+    BOOST_CHECK(surface.textureImages[imageIndex].mimeType == parser.m_SurfaceData.textureImages[imageIndex].mimeType);
+  }
+}
+
+static void runParseStatsTest(const ScanSpec& spec)
+{
+  const fs::path dcm = fs::path(TEST_DATA_DIR) / "real-world" / spec.filename;
+  BOOST_REQUIRE_MESSAGE(fs::exists(dcm), "DCM file not found: " << dcm.string());
+
+  Open3SDCM::ParseOptions options;
+  options.collectStats = true;
+  Open3SDCM::DCMParser parser;
+  parser.ParseDCM(dcm, options);
+  const Open3SDCM::ParseStats& stats = parser.m_Stats;
+  BOOST_REQUIRE(stats.collected);
+  BOOST_CHECK_EQUAL(stats.fileRead.bytes, fs::file_size(dcm));
+  BOOST_CHECK_EQUAL(stats.xmlParse.bytes, fs::file_size(dcm));
+  BOOST_CHECK_EQUAL(stats.cacheLoad.calls, 0U);
+  // A textured CE scan goes through every decode stage
+  for (const auto* stage : {&stats.xmlParse, &stats.base64Decode, &stats.decrypt, &stats.checksum,
+                            &stats.facetDecode, &stats.uvDecode, &stats.textureDecode})
+  {
+    BOOST_CHECK_GT(stage->calls, 0U);
+    BOOST_CHECK_GT(stage->bytes, 0U);
+    BOOST_CHECK_GE(stage->seconds, 0.0);
+  }
+  BOOST_CHECK_EQUAL(stats.checksum.bytes, parser.m_Vertices.size() * sizeof(float));
+  BOOST_CHECK_GE(stats.peakBufferBytes, parser.m_Vertices.size() * sizeof(float));
+  BOOST_CHECK_GT(stats.bufferAllocations, 0U);
+  BOOST_CHECK_GT(stats.totalSeconds, 0.0);
+
+  TempOutputDir tmp("parse_stats");
+  const fs::path stl = tmp.path / (fs::path(spec.filename).stem().string() + ".stl");
+  BOOST_REQUIRE(parser.ExportMesh(stl, "stlb"));
+  BOOST_REQUIRE(parser.ExportMesh(stl, "stlb"));
+  BOOST_REQUIRE_EQUAL(stats.exports.count("stlb"), 1U);
+  BOOST_CHECK_EQUAL(stats.exports.at("stlb").calls, 2U);
+  BOOST_CHECK_EQUAL(stats.exports.at("stlb").bytes, 2 * fs::file_size(stl));
+
+  // The concurrent decode charges the same work to the same stages
+  options.concurrentDecode = true;
+  Open3SDCM::DCMParser concurrent;
+  concurrent.ParseDCM(dcm, options);
+  BOOST_REQUIRE(concurrent.m_Stats.collected);
+  BOOST_CHECK_EQUAL(concurrent.m_Stats.base64Decode.bytes, stats.base64Decode.bytes);
+  BOOST_CHECK_EQUAL(concurrent.m_Stats.decrypt.bytes, stats.decrypt.bytes);
+  BOOST_CHECK_EQUAL(concurrent.m_Stats.uvDecode.calls, stats.uvDecode.calls);
+  BOOST_CHECK_EQUAL(concurrent.m_Stats.bufferAllocations, stats.bufferAllocations);
+  BOOST_CHECK(concurrent.m_Stats.exports.empty());
+
+  // A parse without stats clears those of the previous one
+  parser.ParseDCM(dcm);
+  BOOST_CHECK(!parser.m_Stats.collected);
+  BOOST_CHECK_EQUAL(parser.m_Stats.decrypt.calls, 0U);
+  BOOST_CHECK(parser.m_Stats.exports.empty());
+  BOOST_REQUIRE(parser.ExportMesh(stl, "stlb"));
+  BOOST_CHECK(parser.m_Stats.exports.empty());
+}
+
+static void runParserReuseTest(const ScanSpec& spec, const ScanSpec& smallerSpec)
+{
+  const fs::path dcm = fs::path(TEST_DATA_DIR) / "real-world" / spec.filename;
+  const fs::path smallerDcm = fs::path(TEST_DATA_DIR) / "real-world" / smallerSpec.filename;
+  BOOST_REQUIRE_MESSAGE(fs::exists(dcm), "DCM file not found: " << dcm.string());
+  BOOST_REQUIRE_MESSAGE(fs::exists(smallerDcm), "DCM file not found: " << smallerDcm.string());
+
+  Open3SDCM::ParseOptions options;
+  options.collectStats = true;
+  Open3SDCM::DCMParser reference;
+  reference.ParseDCM(dcm, options);
+  BOOST_REQUIRE_EQUAL(reference.m_Triangles.size(), spec.expectedFaces);
+  BOOST_REQUIRE(!reference.m_SurfaceData.textureCoordinates.empty());
+  BOOST_CHECK_GT(reference.m_Stats.bufferAllocations, 0U);
+
+  const auto checkSameAsReference = [&](const Open3SDCM::DCMParser& parser) {
+    BOOST_CHECK(parser.m_Vertices == reference.m_Vertices);
+    BOOST_REQUIRE_EQUAL(parser.m_Triangles.size(), reference.m_Triangles.size());
+    BOOST_CHECK(std::equal(parser.m_Triangles.begin(), parser.m_Triangles.end(), reference.m_Triangles.begin(),
+                           [](const Open3SDCM::Triangle& a, const Open3SDCM::Triangle& b) {
+                             return a.v1 == b.v1 && a.v2 == b.v2 && a.v3 == b.v3;
+                           }));
+    BOOST_REQUIRE_EQUAL(parser.m_SurfaceData.textureCoordinates.size(), reference.m_SurfaceData.textureCoordinates.size());
+    const auto& corners = parser.m_SurfaceData.textureCoordinates[0].cornerCoordinates;
+    const auto& referenceCorners = reference.m_SurfaceData.textureCoordinates[0].cornerCoordinates;
+    BOOST_REQUIRE_EQUAL(corners.size(), referenceCorners.size());
+    BOOST_CHECK(std::equal(corners.begin(), corners.end(), referenceCorners.begin(),
+                           [](const auto& a, const auto& b) {
+                             return a.has_value() == b.has_value() && (!a.has_value() || (a->u == b->u && a->v == b->v));
+                           }));
+    BOOST_REQUIRE_EQUAL(parser.m_SurfaceData.textureImages.size(), reference.m_SurfaceData.textureImages.size());
+    BOOST_CHECK(parser.m_SurfaceData.textureImages[0].imageBytes == reference.m_SurfaceData.textureImages[0].imageBytes);
+  };
+
+  // The second parse of a file, or of a smaller one, fits in the buffers of the first
+  Open3SDCM::DCMParser parser;
+  parser.ParseDCM(dcm, options);
+  BOOST_CHECK_GT(parser.RetainedScratchBytes(), 0U);
+  parser.ParseDCM(smallerDcm, options);
+  BOOST_CHECK_EQUAL(parser.m_Triangles.size(), smallerSpec.expectedFaces);
+  BOOST_CHECK_EQUAL(parser.m_Stats.bufferAllocations, 0U);
+  parser.ParseDCM(dcm, options);
+  BOOST_CHECK_EQUAL(parser.m_Stats.bufferAllocations, 0U);
+  checkSameAsReference(parser);
+
+  options.concurrentDecode = true;
+  parser.ParseDCM(dcm, options);
+  BOOST_CHECK_EQUAL(parser.m_Stats.bufferAllocations, 0U);
+  checkSameAsReference(parser);
+  options.concurrentDecode = false;
+
+  // A moved parser keeps its buffers
+  Open3SDCM::DCMParser moved = std::move(parser);
+  moved.ParseDCM(dcm, options);
+  BOOST_CHECK_EQUAL(moved.m_Stats.bufferAllocations, 0U);
+
+  // Over budget, the buffers are freed and the next parse allocates again
+  options.retainedBufferBudget = 1;
+  moved.ParseDCM(dcm, options);
+  checkSameAsReference(moved);
+  BOOST_CHECK_EQUAL(moved.RetainedScratchBytes(), 0U);
+  moved.ParseDCM(dcm, options);
+  BOOST_CHECK_GT(moved.m_Stats.bufferAllocations, 0U);
+  checkSameAsReference(moved);
+
+  options.retainedBufferBudget = 0;
+  moved.ParseDCM(dcm, options);
+  moved.ReleaseScratch();
+  BOOST_CHECK_EQUAL(moved.RetainedScratchBytes(), 0U);
+  moved.ParseDCM(dcm, options);
+  checkSameAsReference(moved);
+
+  // A file without <Facets> does not inherit the facet decode of the previous one
+  std::string withoutFacets = readTextFile(smallerDcm);
+  const std::size_t facetsBegin = withoutFacets.find("<Facets ");
+  const std::size_t facetsEnd = withoutFacets.find("</Facets>");
+  BOOST_REQUIRE(facetsBegin != std::string::npos && facetsEnd != std::string::npos);
+  withoutFacets.erase(facetsBegin, facetsEnd + std::string_view("</Facets>").size() - facetsBegin);
+  TempOutputDir tmp("parser_reuse");
+  const fs::path noFacetsDcm = tmp.path / "no_facets.dcm";
+  std::ofstream(noFacetsDcm, std::ios::binary) << withoutFacets;
+
+  BOOST_REQUIRE(moved.m_FacetDecodeInfo.reason != Open3SDCM::FacetWidthReason::NotDecoded);
+  moved.ParseDCM(noFacetsDcm, options);
+  BOOST_CHECK_EQUAL(moved.m_Vertices.size() / 3, smallerSpec.expectedVertices);
+  BOOST_CHECK(moved.m_Triangles.empty());
+  BOOST_CHECK(moved.m_FacetDecodeInfo.reason == Open3SDCM::FacetWidthReason::NotDecoded);
+  BOOST_CHECK_EQUAL(moved.m_FacetDecodeInfo.expectedFaceCount, 0U);
+  BOOST_CHECK_EQUAL(moved.m_FacetDecodeInfo.decodedFaceCount, 0U);
+}
+
+// Counts what the parser asks of a caller-supplied resource
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+  std::size_t allocations{0};
+  std::size_t outstandingBytes{0};
+
+private:
+  void* do_allocate(const std::size_t bytes, const std::size_t alignment) override
+  {
+    ++allocations;
+    outstandingBytes += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* pointer, const std::size_t bytes, const std::size_t alignment) override
+  {
+    outstandingBytes -= bytes;
+    std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+  }
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+static void runDocumentResourceTest(const ScanSpec& spec)
+{
+  const fs::path dcm = fs::path(TEST_DATA_DIR) / "real-world" / spec.filename;
+  BOOST_REQUIRE_MESSAGE(fs::exists(dcm), "DCM file not found: " << dcm.string());
+
+  Open3SDCM::DCMParser reference;
+  reference.ParseDCM(dcm);
+
+  // The scanned document goes to the supplied resource and is gone after the parse
+  CountingResource resource;
+  Open3SDCM::ParseOptions options;
+  for (const bool concurrentDecode : {false, true})
+  {
+    options.concurrentDecode = concurrentDecode;
+    Open3SDCM::DCMParser parser(&resource);
+    const std::size_t allocationsBefore = resource.allocations;
+    parser.ParseDCM(dcm, options);
+    BOOST_CHECK_GT(resource.allocations, allocationsBefore);
+    BOOST_CHECK_EQUAL(resource.outstandingBytes, 0U);
+
+    BOOST_CHECK(parser.m_Vertices == reference.m_Vertices);
+    BOOST_REQUIRE_EQUAL(parser.m_Triangles.size(), reference.m_Triangles.size());
+    BOOST_REQUIRE_EQUAL(parser.m_SurfaceData.textureCoordinates.size(), reference.m_SurfaceData.textureCoordinates.size());
+    BOOST_CHECK(parser.m_SurfaceData.textureCoordinates[0].textureCoordId == reference.m_SurfaceData.textureCoordinates[0].textureCoordId);
+    BOOST_CHECK_EQUAL(parser.m_SurfaceData.textureCoordinates[0].cornerCoordinates.size(),
+                      reference.m_SurfaceData.textureCoordinates[0].cornerCoordinates.size());
+    BOOST_REQUIRE_EQUAL(parser.m_SurfaceData.textureImages.size(), reference.m_SurfaceData.textureImages.size());
+    BOOST_CHECK(parser.m_SurfaceData.textureImages[0].id == reference.m_SurfaceData.textureImages[0].id);
+    BOOST_CHECK(parser.m_SurfaceData.textureImages[0].imageBytes == reference.m_SurfaceData.textureImages[0].imageBytes);
+  }
+
+  // Without one, the parser's own arena holds the document and is kept for the next parse
+  BOOST_CHECK_GT(reference.RetainedScratchBytes(), 0U);
+}
+
+static void runLoggingTest(const ScanSpec& spec)
+{
+  const fs::path dcm = fs::path(TEST_DATA_DIR) / "real-world" / spec.filename;
+  BOOST_REQUIRE_MESSAGE(fs::exists(dcm), "DCM file not found: " << dcm.string());
+
+  // Silent by default
+  BOOST_CHECK_EQUAL(Open3SDCM::GetLogger()->level(), spdlog::level::off);
+
+  std::ostringstream captured;
+  auto logger = std::make_shared<spdlog::logger>("test", std::make_shared<spdlog::sinks::ostream_sink_st>(captured));
+  logger->set_pattern("%l %v");
+  logger->set_level(spdlog::level::debug);
+  Open3SDCM::SetLogger(logger);
+
+  Open3SDCM::DCMParser parser;
+  parser.ParseDCM(dcm);
+  Open3SDCM::SetLogger(nullptr);
+  BOOST_CHECK_EQUAL(Open3SDCM::GetLogger()->level(), spdlog::level::off);
+
+  const std::string text = captured.str();
+  BOOST_TEST_MESSAGE(text);
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+  // Compiled out below Open3SDCM_LOG_LEVEL=debug
+  BOOST_CHECK(text.find(fmt::format("debug {} triangles have been read", spec.expectedFaces)) != std::string::npos);
+#endif
+  BOOST_CHECK(text.find("error") == std::string::npos);
+
+  // Messages after the logger was removed go nowhere
+  captured.str({});
+  parser.ParseDCM(dcm);
+  BOOST_CHECK(captured.str().empty());
+}
+
 BOOST_AUTO_TEST_SUITE(RealWorldConversion)
 
 BOOST_AUTO_TEST_CASE(ConvertScan040) { runConversionTest(k_Scans[0]); }
@@ -330,5 +1009,15 @@ BOOST_AUTO_TEST_CASE(ConvertScan039) { runConversionTest(k_Scans[1]); }
 BOOST_AUTO_TEST_CASE(ConvertScan012) { runConversionTest(k_Scans[2]); }
 BOOST_AUTO_TEST_CASE(ConvertScan019) { runConversionTest(k_Scans[3]); }
 BOOST_AUTO_TEST_CASE(ConvertScan045) { runConversionTest(k_Scans[4]); }
+BOOST_AUTO_TEST_CASE(ConcurrentDecodeScan012) { runConcurrentDecodeTest(k_Scans[2]); }
+BOOST_AUTO_TEST_CASE(IndexedUvExportScan012) { runIndexedUvExportTest(k_Scans[2]); }
+BOOST_AUTO_TEST_CASE(GlbExportScan012) { runGlbExportTest(k_Scans[2]); }
+BOOST_AUTO_TEST_CASE(PlybExportScan012) { runPlybExportTest(k_Scans[2]); }
+BOOST_AUTO_TEST_CASE(PlybExportScan040) { runPlybExportTest(k_Scans[0]); }
+BOOST_AUTO_TEST_CASE(MeshCacheScan012) { runMeshCacheTest(k_Scans[2], k_Scans[1]); }
+BOOST_AUTO_TEST_CASE(ParseStatsScan012) { runParseStatsTest(k_Scans[2]); }
+BOOST_AUTO_TEST_CASE(LoggingScan012) { runLoggingTest(k_Scans[2]); }
+BOOST_AUTO_TEST_CASE(ParserReuseScan012) { runParserReuseTest(k_Scans[2], k_Scans[0]); }
+BOOST_AUTO_TEST_CASE(DocumentResourceScan012) { runDocumentResourceTest(k_Scans[2]); }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -18,10 +18,13 @@ int main(int argc, char** argv)
         po::options_description desc("Mesh Comparison Test Tool");
         desc.add_options()
             ("help,h", "Show help message")
-            ("dcm,d", po::value<fs::path>()->required(), "Input DCM file")
-            ("reference,r", po::value<fs::path>()->required(), "Reference mesh file (STL, OBJ, PLY, etc.)")
+            // Paths as strings: reading an fs::path option stops at the first space
+            ("dcm,d", po::value<std::string>()->required(), "Input DCM file")
+            ("reference,r", po::value<std::string>()->required(), "Reference mesh file (STL, OBJ, PLY, etc.)")
+            ("format,f", po::value<std::string>(), "Optional: export format (default: the reference's extension); stlb compares binary STL facets and normals")
             ("epsilon,e", po::value<float>()->default_value(1e-5f), "Tolerance for vertex comparison")
-            ("output,o", po::value<fs::path>(), "Optional: output directory for generated mesh");
+            ("normal_epsilon", po::value<float>()->default_value(1e-3f), "Tolerance for facet normals (stlb)")
+            ("output,o", po::value<std::string>(), "Optional: output directory for generated mesh");
 
         po::variables_map vm;
         po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -34,9 +37,10 @@ int main(int argc, char** argv)
 
         po::notify(vm);
 
-        fs::path dcmFile = vm["dcm"].as<fs::path>();
-        fs::path referenceFile = vm["reference"].as<fs::path>();
+        fs::path dcmFile = vm["dcm"].as<std::string>();
+        fs::path referenceFile = vm["reference"].as<std::string>();
         float epsilon = vm["epsilon"].as<float>();
+        float normalEpsilon = vm["normal_epsilon"].as<float>();
 
         // Validate input files
         if (!fs::exists(dcmFile))
@@ -64,11 +68,12 @@ int main(int argc, char** argv)
         {
             refExtension = refExtension.substr(1);
         }
+        const std::string exportFormat = vm.count("format") ? vm["format"].as<std::string>() : refExtension;
 
         fmt::print("=== Open3SDCM Mesh Comparison Test ===\n\n");
         fmt::print("DCM File:       {}\n", dcmFile.string());
         fmt::print("Reference File: {}\n", referenceFile.string());
-        fmt::print("Output Format:  {}\n", refExtension);
+        fmt::print("Output Format:  {}\n", exportFormat);
         fmt::print("Epsilon:        {}\n\n", epsilon);
 
         // Step 1: Parse DCM file
@@ -87,12 +92,12 @@ int main(int argc, char** argv)
                    parseDuration.count());
 
         // Step 2: Export to temporary file or specified directory
-        fmt::print("Step 2: Exporting to {} format...\n", refExtension);
+        fmt::print("Step 2: Exporting to {} format...\n", exportFormat);
 
         fs::path outputDir;
         if (vm.count("output"))
         {
-            outputDir = vm["output"].as<fs::path>();
+            outputDir = vm["output"].as<std::string>();
         }
         else
         {
@@ -105,7 +110,7 @@ int main(int argc, char** argv)
 
         auto exportStart = std::chrono::high_resolution_clock::now();
 
-        if (!parser.ExportMesh(generatedFile, refExtension))
+        if (!parser.ExportMesh(generatedFile, exportFormat))
         {
             fmt::print(stderr, "Error: Failed to export mesh\n");
             return 1;
@@ -117,6 +122,17 @@ int main(int argc, char** argv)
         fmt::print("  Exported to: {}\n", generatedFile.string());
         fmt::print("  Export time: {} ms\n\n", exportDuration.count());
 
+        // Binary STL: compare the files facet by facet, normals included
+        if (exportFormat == "stlb")
+        {
+            fmt::print("Step 3: Comparing binary STL facets...\n");
+            const auto referenceStl = Open3SDCM::Test::MeshComparator::loadBinaryStl(referenceFile);
+            const auto generatedStl = Open3SDCM::Test::MeshComparator::loadBinaryStl(generatedFile);
+            const auto stlResult = Open3SDCM::Test::MeshComparator::compareBinaryStl(referenceStl, generatedStl, epsilon, normalEpsilon);
+            Open3SDCM::Test::MeshComparator::printResult(stlResult);
+            return stlResult.isSuccess() ? 0 : 1;
+        }
+
         // Step 3: Load reference mesh
         fmt::print("Step 3: Loading reference mesh...\n");
         auto loadRefStart = std::chrono::high_resolution_clock::now();